@@ -0,0 +1,99 @@
+#!/usr/bin/env python3.7
+
+# Front-end benchmark: generates a synthetic program with gencorpus.py and
+# times bin/pcl on it, stopping after the scanner (--stop-after=lex), after
+# the parser (--stop-after=parse) and after the whole compilation. Every
+# measurement is the median of several runs, minus the median time bin/pcl
+# takes on an empty program (process start-up and LLVM initialization).
+
+import argparse
+import json
+import os
+import statistics
+import subprocess as sp
+import sys
+import tempfile
+import time
+from os.path import dirname, join
+
+benchdir = dirname(os.path.realpath(__file__))
+pcl = join(benchdir, '..', 'bin', 'pcl')
+
+parser = argparse.ArgumentParser(
+    description='time the lexer, the parser and bin/pcl on a synthetic PCL program',
+    epilog='any other argument is passed to gencorpus.py to shape the program (see gencorpus.py -h)'
+)
+parser.add_argument('-n', '--runs', type=int, default=7, metavar='N',
+    help='runs per measurement, the median is reported (default: 7)')
+parser.add_argument('--corpus', metavar='FILE',
+    help='benchmark FILE instead of generating a program')
+parser.add_argument('--json', metavar='FILE',
+    help='also write the results to FILE as JSON')
+
+
+# median wall-clock time of running cmd, its output of the last run
+def measure(cmd, runs):
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        proc = sp.run(cmd, stdout=sp.PIPE, stderr=sp.PIPE, universal_newlines=True)
+        times.append(time.perf_counter() - start)
+        if proc.returncode != 0:
+            sys.stderr.write('ERROR: %s failed:\n%s' % (' '.join(cmd), proc.stderr))
+            exit(1)
+    return statistics.median(times), proc.stdout
+
+
+def main():
+    args, corpus_args = parser.parse_known_args()
+    if not os.path.exists(pcl):
+        sys.stderr.write('ERROR: %s not found, run make first\n' % pcl)
+        exit(1)
+
+    with tempfile.TemporaryDirectory(prefix='pcl-bench-') as tmp:
+        source = args.corpus
+        if source is None:
+            source = join(tmp, 'corpus.pcl')
+            sp.run([sys.executable, join(benchdir, 'gencorpus.py'), '-o', source, *corpus_args], check=True)
+        empty = join(tmp, 'empty.pcl')
+        with open(empty, 'w') as f:
+            f.write('program empty;\nbegin\nend.\n')
+        size = os.path.getsize(source)
+        output = join(tmp, 'corpus.o')
+
+        startup, _ = measure([pcl, '--stop-after=lex', empty], args.runs)
+        lex, out = measure([pcl, '--stop-after=lex', source], args.runs)
+        tokens = int(out.split()[0])
+        parse, _ = measure([pcl, '--stop-after=parse', source], args.runs)
+        full, _ = measure([pcl, '-x', '-c', '-o', output, source], args.runs)
+
+    lex = max(lex - startup, 1e-9)
+    parse = max(parse - startup, 1e-9)
+    full = max(full - startup, 1e-9)
+    results = {
+        'source_bytes': size,
+        'tokens': tokens,
+        'runs': args.runs,
+        'startup_seconds': startup,
+        'lex_seconds': lex,
+        'lex_tokens_per_second': tokens / lex,
+        'parse_seconds': parse,
+        'parse_tokens_per_second': tokens / parse,
+        'compile_seconds': full,
+    }
+
+    mb = size / (1024 * 1024)
+    print('%s: %.2f MB, %d tokens, median of %d runs (start-up %.3fs subtracted)'
+          % (args.corpus or 'generated corpus', mb, tokens, args.runs, startup))
+    print('  %-8s %9.3fs %12.0f tokens/s %8.1f MB/s' % ('lex', lex, tokens / lex, mb / lex))
+    print('  %-8s %9.3fs %12.0f tokens/s %8.1f MB/s' % ('parse', parse, tokens / parse, mb / parse))
+    print('  %-8s %9.3fs' % ('compile', full))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(results, f, indent=2)
+            f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3.7
+
+# Generate a synthetic PCL program for the front-end benchmarks (see
+# bench/bench.py). Every knob scales one thing the lexer and the parser
+# have to chew through; the program is valid, so it can be compiled end
+# to end as well.
+
+import argparse
+import random
+from sys import stdout
+
+parser = argparse.ArgumentParser(
+    description='generate a synthetic PCL program of configurable size'
+)
+parser.add_argument('--procedures', type=int, default=200, metavar='N',
+    help='number of procedures (default: 200)')
+parser.add_argument('--statements', type=int, default=50, metavar='N',
+    help='statements in the body of every procedure (default: 50)')
+parser.add_argument('--args', type=int, default=2, metavar='N',
+    help='parameters of every procedure, and arguments of every call to it (default: 2, at least 2)')
+parser.add_argument('--depth', type=int, default=8, metavar='N',
+    help='nesting depth of the if/while blocks in every procedure (default: 8)')
+parser.add_argument('--expr-length', type=int, default=40, metavar='N',
+    help='operands in the long expressions (default: 40)')
+parser.add_argument('--string-length', type=int, default=2000, metavar='N',
+    help='characters in the big string literals (default: 2000)')
+parser.add_argument('--name-length', type=int, default=1, metavar='N',
+    help='length of the variable names, longer names make an identifier-dense program (default: 1)')
+parser.add_argument('--comment-lines', type=int, default=20, metavar='N',
+    help='lines of the comment in front of every procedure (default: 20)')
+parser.add_argument('--seed', type=int, default=42,
+    help='random seed, the same arguments and seed give the same program')
+parser.add_argument('-o', dest='output', metavar='FILE',
+    help='write the program to FILE instead of stdout')
+
+WORDS = ['alpha', 'beta', 'gamma', 'delta', 'lexer', 'parser', 'token', 'scope', 'value', 'result']
+
+
+def comment(rnd, lines):
+    body = '\n'.join('   ' + ' '.join(rnd.choice(WORDS) for _ in range(10)) for _ in range(lines))
+    return '(*\n' + body + '\n*)\n'
+
+
+def string(rnd, length):
+    text = ''.join(rnd.choice('abcdefghijklmnopqrstuvwxyz ,.') for _ in range(length))
+    return '"' + text + '\\n"'
+
+
+def expression(rnd, names, length):
+    # parenthesized every few operands, so that the grouping gets deep too
+    out = rnd.choice(names)
+    for i in range(1, length):
+        out += ' ' + rnd.choice(['+', '-', '*']) + ' ' + (rnd.choice(names) if rnd.random() < 0.7 else str(rnd.randint(0, 999)))
+        if i % 5 == 0:
+            out = '(' + out + ')'
+    return out
+
+
+# the name of variable v, padded to --name-length
+def var(args, v):
+    return (v + '_' + 'identifier' * args.name_length)[:max(args.name_length, 1)]
+
+
+def statements(rnd, args, count, depth, indent):
+    a, b, x, y = (var(args, v) for v in 'abxy')
+    names = [a, b, x, y]
+    out = []
+    pad = '  ' * indent
+    for i in range(count):
+        kind = i % 4
+        if kind == 0:
+            out.append(pad + rnd.choice([x, y]) + ' := ' + expression(rnd, names, args.expr_length))
+        elif kind == 1:
+            out.append(pad + 'writeInteger(' + expression(rnd, names, 4) + ')')
+        elif kind == 2:
+            out.append(pad + 'writeString(' + string(rnd, args.string_length // 10) + ')')
+        else:
+            out.append(pad + y + ' := ' + y + ' + 1')
+    if depth > 0:
+        inner = statements(rnd, args, max(count // 4, 1), depth - 1, indent + 1)
+        if depth % 2 == 0:
+            out.append(pad + 'if ' + x + ' < ' + y + ' then\n' + pad + 'begin\n' + inner + '\n' + pad + 'end')
+        else:
+            out.append(pad + 'while ' + y + ' < 0 do\n' + pad + 'begin\n' + inner + ';\n' + pad + '  ' + y + ' := ' + y + ' + 1\n' + pad + 'end')
+    return ';\n'.join(out)
+
+
+def program(args):
+    rnd = random.Random(args.seed)
+    out = ['program bench;\n', comment(rnd, args.comment_lines), 'var g: integer;\n\n']
+    a, b, x, y = (var(args, v) for v in 'abxy')
+    for p in range(args.procedures):
+        out.append(comment(rnd, args.comment_lines))
+        extra = ''.join('; q%d: integer' % q for q in range(args.args - 2))
+        out.append('procedure p%d(%s: integer; %s: integer%s);\n' % (p, a, b, extra))
+        out.append('var %s, %s: integer;\n' % (x, y))
+        out.append('begin\n')
+        out.append('  %s := %s;\n  %s := %s;\n' % (x, a, y, b))
+        out.append('  writeString(' + string(rnd, args.string_length) + ');\n')
+        out.append(statements(rnd, args, args.statements, args.depth, 1) + '\n')
+        out.append('end;\n\n')
+    out.append('begin\n  g := 0')
+    for p in range(args.procedures):
+        out.append(';\n  p%d(g, %d%s)' % (p, p, ', 0' * (args.args - 2)))
+    out.append('\nend.\n')
+    return ''.join(out)
+
+
+if __name__ == '__main__':
+    args = parser.parse_args()
+    if args.args < 2:
+        parser.error('--args must be at least 2')
+    text = program(args)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        stdout.write(text)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3.7
+
+# Scaling check: compiles synthetic programs (gencorpus.py) at two sizes of
+# one knob and fails unless the compile time grows about linearly with it.
+# The default checks are a block of 100k statements and procedures taking
+# (and called with) 1k arguments, each against half that size; a quadratic
+# pass over the statements or the arguments makes the time four times as
+# long instead of twice. Times are medians of several runs of the whole
+# compilation (bin/pcl -x -c), minus the time bin/pcl takes on an empty
+# program.
+#
+# Pending: it has not been run against a built bin/pcl yet, so the limit
+# (--tolerance) is not calibrated and a pass does not yet vouch for the
+# list-building fixes; record the observed times when it first runs.
+
+import argparse
+import os
+import subprocess as sp
+import sys
+import tempfile
+from os.path import dirname, join
+
+from bench import measure, pcl
+
+benchdir = dirname(os.path.realpath(__file__))
+
+# knob, its size, and the rest of the program kept small around it
+CHECKS = [
+    ('statements', 100000, ['--procedures', '1', '--depth', '0', '--expr-length', '4',
+                            '--string-length', '20', '--comment-lines', '0']),
+    ('args', 1000, ['--procedures', '100', '--statements', '4', '--depth', '0',
+                    '--expr-length', '4', '--string-length', '20', '--comment-lines', '0']),
+]
+
+parser = argparse.ArgumentParser(
+    description='check that the compile time of bin/pcl grows linearly with long blocks and argument lists'
+)
+parser.add_argument('-n', '--runs', type=int, default=3, metavar='N',
+    help='runs per measurement, the median is used (default: 3)')
+parser.add_argument('--statements', type=int, default=CHECKS[0][1], metavar='N',
+    help='statements in the block of the large program (default: %d)' % CHECKS[0][1])
+parser.add_argument('--args', type=int, default=CHECKS[1][1], metavar='N',
+    help='arguments of every call in the large program (default: %d)' % CHECKS[1][1])
+parser.add_argument('--tolerance', type=float, default=1.5, metavar='X',
+    help='fail if doubling the size makes the compilation more than 2*X times as long (default: 1.5)')
+
+
+def compile_time(tmp, name, size, rest, args, startup):
+    source = join(tmp, '%s-%d.pcl' % (name, size))
+    sp.run([sys.executable, join(benchdir, 'gencorpus.py'), '-o', source, '--' + name, str(size), *rest],
+           check=True)
+    seconds, _ = measure([pcl, '-x', '-c', '-o', join(tmp, 'out.o'), source], args.runs)
+    return max(seconds - startup, 1e-3)
+
+
+def main():
+    args = parser.parse_args()
+    if not os.path.exists(pcl):
+        sys.stderr.write('ERROR: %s not found, run make first\n' % pcl)
+        exit(1)
+
+    failed = False
+    with tempfile.TemporaryDirectory(prefix='pcl-scaling-') as tmp:
+        empty = join(tmp, 'empty.pcl')
+        with open(empty, 'w') as f:
+            f.write('program empty;\nbegin\nend.\n')
+        startup, _ = measure([pcl, '-x', '-c', '-o', join(tmp, 'out.o'), empty], args.runs)
+
+        for name, _, rest in CHECKS:
+            large = getattr(args, name)
+            small = large // 2
+            t_small = compile_time(tmp, name, small, rest, args, startup)
+            t_large = compile_time(tmp, name, large, rest, args, startup)
+            ratio = t_large / t_small
+            limit = args.tolerance * large / small
+            ok = ratio <= limit
+            failed = failed or not ok
+            print('  --%-11s %7d: %8.3fs %7d: %8.3fs  x%.2f (limit x%.2f)  %s'
+                  % (name, small, t_small, large, t_large, ratio, limit, 'ok' if ok else 'NOT LINEAR'))
+
+    if failed:
+        sys.stderr.write('ERROR: compile time grows faster than the program\n')
+        exit(1)
+
+
+if __name__ == '__main__':
+    main()
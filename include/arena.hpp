@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/* ---------------------------------------------------------------------
+   -------------------------------- Arena ------------------------------
+   ---------------------------------------------------------------------
+   Bump allocator for the nodes of one compilation (the AST and its
+   types). Nodes are carved one after the other out of large blocks and
+   are never freed one at a time: a node adopted by the arena is
+   destroyed, with all the others, when the arena is, and then the
+   blocks go back in one go.
+   > blocks:  every block allocated so far (the last one is being filled)
+   > next:    first free byte of the last block
+   > end:     end of the last block
+   > nodes:   the adopted nodes, destroyed in reverse order
+ ----------------------------------------------------------------------- */
+
+template <typename Node>
+class Arena {
+public:
+  Arena() = default;
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+  ~Arena() {
+    for (auto n = nodes.rbegin(); n != nodes.rend(); ++n) (*n)->~Node();
+    for (char *b : blocks) std::free(b);
+  }
+
+  void *allocate(size_t size) {
+    size = (size + Align - 1) & ~(Align - 1);
+    if (size > size_t(end - next)) {
+      size_t len = size > BlockSize ? size : BlockSize;
+      char *b = static_cast<char *>(std::malloc(len));
+      if (!b) {
+        std::cerr << "ERROR: out of memory\n";
+        exit(1);
+      }
+      blocks.push_back(b);
+      next = b;
+      end = b + len;
+    }
+    void *p = next;
+    next += size;
+    return p;
+  }
+
+  void adopt(Node *n) { nodes.push_back(n); }
+
+private:
+  static const size_t Align = alignof(std::max_align_t);
+  static const size_t BlockSize = 64 * 1024;
+
+  std::vector<char *> blocks;
+  char *next = nullptr;
+  char *end = nullptr;
+  std::vector<Node *> nodes;
+};
@@ -7,8 +7,13 @@
 #include <stack>
 #include "symbol.hpp"
 #include "lexer.hpp"
+#include "name.hpp"
 #include "llvm.hpp"
+#include "compilation.hpp"
 #include "general.hpp"
+#include "driver.hpp"
+#include "timing.hpp"
+#include "trace.hpp"
 
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
@@ -49,256 +54,265 @@ inline std::ostream& operator<<(std::ostream &out, Types t) {
   return out;
 }
 
+/* ---------------------------------------------------------------------
+   ------------------------------ Operators ----------------------------
+   ---------------------------------------------------------------------
+   The lexer hands BinOp/UnOp an opcode ("+" and "-" are OP_add/OP_sub
+   in unary position as well, "/" is OP_div and "div" is OP_intdiv).
+ ----------------------------------------------------------------------- */
+
+enum Opcode {
+  OP_add, OP_sub, OP_mul, OP_div, OP_intdiv, OP_mod,
+  OP_eq, OP_neq, OP_lt, OP_gt, OP_le, OP_ge,
+  OP_and, OP_or, OP_not
+};
+
+inline const char *opName(Opcode op) {
+  static const char *names[] = {
+    "+", "-", "*", "/", "div", "mod",
+    "=", "<>", "<", ">", "<=", ">=",
+    "and", "or", "not"
+  };
+  return names[op];
+}
+
+inline std::ostream& operator<<(std::ostream &out, Opcode op) {
+  return out << opName(op);
+}
+
 class AST {
 public:
+  // nodes live in the arena of their compilation and are destroyed with
+  // it: never delete one (operator delete is only there for new)
+  AST() { cx->arena.adopt(this); }
   virtual ~AST() {}
+  static void *operator new(size_t size) { return cx->arena.allocate(size); }
+  static void operator delete(void *) {}
+
   virtual void printOn(std::ostream &out) const = 0;
   virtual std::string getstring() { return "AST()";}
   virtual void sem() {}
   virtual void semfor(){}
   virtual Value* compile() const = 0;
   void llvm_compile_and_dump(){
-    // Initialize the module and the optimization passes.
-    TheModule = make_unique<Module>("pcl program", TheContext);
-    TheFPM = make_unique<legacy::FunctionPassManager>(TheModule.get());
-    // TheFPM->add(createPromoteMemoryToRegisterPass());
-    // TheFPM->add(createInstructionCombiningPass());
-    // TheFPM->add(createReassociatePass());
-    // TheFPM->add(createGVNPass());
-    // TheFPM->add(createCFGSimplificationPass());
-    TheFPM->doInitialization();
+    TimePhase t(PHASE_irgen);
+    // Initialize the module (the optimization passes run in runBackend).
+    cx->TheModule = make_unique<Module>("pcl program", cx->TheContext);
 
     /***********declare lib functions***********/
 
     // declare void @writeInteger(i64)
     FunctionType *writeInteger_type =
-      FunctionType::get(Type::getVoidTy(TheContext),
-                        std::vector<Type *> { i64 }, false);
-    TheWriteInteger =
+      FunctionType::get(Type::getVoidTy(cx->TheContext),
+                        std::vector<Type *> { cx->i64 }, false);
+    cx->TheWriteInteger =
       Function::Create(writeInteger_type, Function::ExternalLinkage,
-                       "writeInteger", TheModule.get());
+                       "writeInteger", cx->TheModule.get());
     // declare void @writeReal(X86_FP80TyID)
     FunctionType *writeReal_type =
-      FunctionType::get(Type::getVoidTy(TheContext),
-                std::vector<Type *> { X86_FP80TyID }, false);
-    TheWriteReal =
+      FunctionType::get(Type::getVoidTy(cx->TheContext),
+                std::vector<Type *> { cx->X86_FP80TyID }, false);
+    cx->TheWriteReal =
       Function::Create(writeReal_type, Function::ExternalLinkage,
-                "writeReal", TheModule.get());
+                "writeReal", cx->TheModule.get());
     // declare void @writeBoolean(i1)
     FunctionType *writeBoolean_type =
-      FunctionType::get(Type::getVoidTy(TheContext),
-                        std::vector<Type *> { i1 }, false);
-    TheWriteBoolean =
+      FunctionType::get(Type::getVoidTy(cx->TheContext),
+                        std::vector<Type *> { cx->i1 }, false);
+    cx->TheWriteBoolean =
       Function::Create(writeBoolean_type, Function::ExternalLinkage,
-                       "writeBoolean", TheModule.get());
+                       "writeBoolean", cx->TheModule.get());
     // declare void @writeChar(i8)
     FunctionType *writeChar_type =
-      FunctionType::get(Type::getVoidTy(TheContext),
-                        std::vector<Type *> { i8 }, false);
-    TheWriteChar =
+      FunctionType::get(Type::getVoidTy(cx->TheContext),
+                        std::vector<Type *> { cx->i8 }, false);
+    cx->TheWriteChar =
       Function::Create(writeChar_type, Function::ExternalLinkage,
-                       "writeChar", TheModule.get());
+                       "writeChar", cx->TheModule.get());
     // declare void @writeString(i8*)
     FunctionType *writeString_type =
-      FunctionType::get(Type::getVoidTy(TheContext),
-                        std::vector<Type *> { PointerType::get(i8, 0) }, false);
-    TheWriteString =
+      FunctionType::get(Type::getVoidTy(cx->TheContext),
+                        std::vector<Type *> { PointerType::get(cx->i8, 0) }, false);
+    cx->TheWriteString =
       Function::Create(writeString_type, Function::ExternalLinkage,
-                       "writeString", TheModule.get());
+                       "writeString", cx->TheModule.get());
     //declare int @readInteger(i32)
     FunctionType *readInteger_type =
-        FunctionType::get(i32, std::vector<llvm::Type *>{}, false);
-    TheReadInteger =
+        FunctionType::get(cx->i32, std::vector<llvm::Type *>{}, false);
+    cx->TheReadInteger =
       Function::Create(readInteger_type, Function::ExternalLinkage,
-                       "readInteger", TheModule.get());
+                       "readInteger", cx->TheModule.get());
     //declare int @readBoolean(i32)
     FunctionType *readBoolean_type =
-        FunctionType::get(i32, std::vector<llvm::Type *>{}, false);
-    TheReadBoolean =
+        FunctionType::get(cx->i32, std::vector<llvm::Type *>{}, false);
+    cx->TheReadBoolean =
       Function::Create(readBoolean_type, Function::ExternalLinkage,
-                       "readBoolean", TheModule.get());
+                       "readBoolean", cx->TheModule.get());
     //declare int @readChar(i8)
     FunctionType *readChar_type =
-        FunctionType::get(i32, std::vector<llvm::Type *>{}, false);
-    TheReadChar =
+        FunctionType::get(cx->i32, std::vector<llvm::Type *>{}, false);
+    cx->TheReadChar =
       Function::Create(readChar_type, Function::ExternalLinkage,
-                       "readChar", TheModule.get());
+                       "readChar", cx->TheModule.get());
     //declare int @readString(*i8)
     FunctionType *readString_type =
-        FunctionType::get(PointerType::get(i8, 0), std::vector<llvm::Type *>{}, false);
-    TheReadString =
+        FunctionType::get(PointerType::get(cx->i8, 0), std::vector<llvm::Type *>{}, false);
+    cx->TheReadString =
       Function::Create(readString_type, Function::ExternalLinkage,
-                       "readString", TheModule.get());
+                       "readString", cx->TheModule.get());
     
     // declare i32 @abs(i32)
     FunctionType *abs_type =
-      FunctionType::get(i32,
-                        std::vector<Type *> { i32 }, false);
-    TheAbs =
+      FunctionType::get(cx->i32,
+                        std::vector<Type *> { cx->i32 }, false);
+    cx->TheAbs =
       Function::Create(abs_type, Function::ExternalLinkage,
-                       "abs", TheModule.get());
+                       "abs", cx->TheModule.get());
 
     FunctionType *math_real_type =
-      FunctionType::get(X86_FP80TyID,
-                        std::vector<Type *> { X86_FP80TyID }, false);
+      FunctionType::get(cx->X86_FP80TyID,
+                        std::vector<Type *> { cx->X86_FP80TyID }, false);
     //declare X86_FP80TyID @fabs(X86_FP80TyID)
-    TheFabs =
+    cx->TheFabs =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "fabs", TheModule.get());
+                       "fabs", cx->TheModule.get());
     //declare X86_FP80TyID @sqrt(X86_FP80TyID)
-    TheSqrt =
+    cx->TheSqrt =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "sqrt", TheModule.get());
+                       "sqrt", cx->TheModule.get());
     //declare X86_FP80TyID @sin(X86_FP80TyID)
-    TheSin =
+    cx->TheSin =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "sin", TheModule.get());
+                       "sin", cx->TheModule.get());
     //declare X86_FP80TyID @cos(X86_FP80TyID)
-    TheCos =
+    cx->TheCos =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "cos", TheModule.get());
+                       "cos", cx->TheModule.get());
     //declare X86_FP80TyID @tan(X86_FP80TyID)
-    TheTan =
+    cx->TheTan =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "tan", TheModule.get());
+                       "tan", cx->TheModule.get());
     //declare X86_FP80TyID @atan(X86_FP80TyID)
-    TheArctan =
+    cx->TheArctan =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "atan", TheModule.get());
+                       "atan", cx->TheModule.get());
     //declare X86_FP80TyID @exp(X86_FP80TyID)
-    TheExp =
+    cx->TheExp =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "exp", TheModule.get());
+                       "exp", cx->TheModule.get());
     //declare X86_FP80TyID @ln(X86_FP80TyID)
-    TheLn =
+    cx->TheLn =
       Function::Create(math_real_type, Function::ExternalLinkage,
-                       "ln", TheModule.get());
+                       "ln", cx->TheModule.get());
     //declare X86_FP80TyID @pi()
     FunctionType *pi_type =
-        FunctionType::get(X86_FP80TyID, std::vector<llvm::Type *>{}, false);
-    ThePi =
+        FunctionType::get(cx->X86_FP80TyID, std::vector<llvm::Type *>{}, false);
+    cx->ThePi =
       Function::Create(pi_type, Function::ExternalLinkage,
-                       "pi", TheModule.get());
+                       "pi", cx->TheModule.get());
     FunctionType *conv_type =
-    	FunctionType::get(i32, std::vector<llvm::Type *> { X86_FP80TyID }, false);
+    	FunctionType::get(cx->i32, std::vector<llvm::Type *> { cx->X86_FP80TyID }, false);
     //declare i32 @trunc(X86_FP80TyID)
-    TheTrunc =
+    cx->TheTrunc =
       Function::Create(conv_type, Function::ExternalLinkage,
-      	               "trunc", TheModule.get());
+      	               "trunc", cx->TheModule.get());
     //declare i32 @round(X86_FP80TyID)
-    TheRound =
+    cx->TheRound =
       Function::Create(conv_type, Function::ExternalLinkage,
-      	               "round", TheModule.get());
+      	               "round", cx->TheModule.get());
     //declare i32 @ord(i8)
     FunctionType *ord_type =
-    	FunctionType::get(i32, std::vector<llvm::Type *> { i8 }, false);
-    TheOrd =
+    	FunctionType::get(cx->i32, std::vector<llvm::Type *> { cx->i8 }, false);
+    cx->TheOrd =
       Function::Create(ord_type, Function::ExternalLinkage,
-      	               "ord", TheModule.get());
+      	               "ord", cx->TheModule.get());
     //declare i8 @chr(i32)
     FunctionType *chr_type =
-    	FunctionType::get(i8, std::vector<llvm::Type *> { i32 }, false);
-    TheChr =
+    	FunctionType::get(cx->i8, std::vector<llvm::Type *> { cx->i32 }, false);
+    cx->TheChr =
       Function::Create(chr_type, Function::ExternalLinkage,
-      	               "chr", TheModule.get());
+      	               "chr", cx->TheModule.get());
 
 
 
     // Define and start the main function.
-    loggedinfo.openScope();
+    cx->loggedinfo.openScope();
     Function *main =
-      cast<Function>(TheModule->getOrInsertFunction("main", i32));
-    loggedinfo.addFunctionInScope("main", main);
+      cast<Function>(cx->TheModule->getOrInsertFunction("main", cx->i32));
+    cx->loggedinfo.addFunctionInScope(NAME_main, main);
     // // Emit the program code.
     compile();
     // Verify the IR.
-    bool bad = verifyModule(*TheModule, &errs());
+    bool bad;
+    {
+      TimePhase t(PHASE_verify);
+      bad = verifyModule(*cx->TheModule, &errs());
+    }
     if (bad) {
       std::cerr << "The IR is bad!" << std::endl;
       std::exit(1);
     }
-    TheFPM->run(*main);
-    // Print out the IR.
-    TheModule->print(outs(), nullptr);
+    // Optimize, emit the object code and link the executable (or run it).
+    runBackend(std::move(cx->TheModule));
   }
 protected:
-  // Global LLVM variables related to the LLVM suite.
-  static LLVMContext TheContext;
-  static IRBuilder<> Builder;
-  static std::unique_ptr<Module> TheModule;
-  static std::unique_ptr<legacy::FunctionPassManager> TheFPM;
-
-  static Function *TheWriteInteger;
-  static Function *TheWriteBoolean;
-  static Function *TheWriteChar;
-  static Function *TheWriteReal;
-  static Function *TheWriteString;
-  static Function *TheReadInteger;
-  static Function *TheReadBoolean;
-  static Function *TheReadChar;
-  static Function *TheReadString;
-  static Function *TheAbs;
-  static Function *TheFabs;
-  static Function *TheSqrt;
-  static Function *TheSin;
-  static Function *TheCos;
-  static Function *TheTan;
-  static Function *TheArctan;
-  static Function *TheExp;
-  static Function *ThePi;
-  static Function *TheLn;
-  static Function *TheTrunc;
-  static Function *TheRound;
-  static Function *TheOrd;
-  static Function *TheChr;
-
-  // Useful LLVM types.
-  static Type *i1;
-  static Type *i8;
-  static Type *i32;
-  static Type *i64;
-  static Type *X86_FP80TyID;
+  // verifier calls are timed apart from IR generation (--time-report)
+  static bool verify(llvm::Function *F) {
+    TimePhase t(PHASE_verify);
+    return llvm::verifyFunction(*F, &llvm::errs());
+  }
 
   // Useful LLVM helper functions.
   ConstantInt* c1(char c) const {
-    return ConstantInt::get(TheContext, APInt(1, c, true));
+    return ConstantInt::get(cx->TheContext, APInt(1, c, true));
   }
   ConstantInt* c8(char c) const {
-    return ConstantInt::get(TheContext, APInt(8, c, true));
+    return ConstantInt::get(cx->TheContext, APInt(8, c, true));
   }
   ConstantInt* c32(int n) const {
-    return ConstantInt::get(TheContext, APInt(32, n, true));
+    return ConstantInt::get(cx->TheContext, APInt(32, n, true));
   }
   ConstantFP* fp32(float d) const {
-    return ConstantFP::get(TheContext, APFloat(d));
+    return ConstantFP::get(cx->TheContext, APFloat(d));
   }
-  // calculate variable address
-  virtual Value *calcAddr (std::string id, std::string function, Value * index = nullptr) const {
+  // calculate variable address (through the symbol sem resolved id to,
+  // when it is bound in the current scope)
+  virtual Value *calcAddr (Name id, const char *function, Value * index = nullptr, Symbol *sym = nullptr) const {
     
     llvm::Value *addr;
     llvm::Type *t;
+    llvm::Type *vtype;
+    llvm::AllocaInst *valloca;
+    if (cx->loggedinfo.bound(sym)) {
+      vtype = sym->llvmType;
+      valloca = sym->alloca;
+    }
+    else {
+      vtype = cx->loggedinfo.getVarType(id);
+      valloca = cx->loggedinfo.getVarAlloca(id);
+    }
     // dereference if necessary
-    if (loggedinfo.isPointer(id)) {
+    if (vtype->isPointerTy()) {
       
-      addr = Builder.CreateLoad(loggedinfo.getVarAlloca(id));
-      t = loggedinfo.getVarType(id)->getPointerElementType();
+      addr = cx->Builder.CreateLoad(valloca);
+      t = vtype->getPointerElementType();
     }
     else {
       
-      addr = loggedinfo.getVarAlloca(id);
-      t = loggedinfo.getVarType(id);
+      addr = valloca;
+      t = vtype;
     }
     
     // id is an array
     if (t->isArrayTy()){
       
-      addr = Builder.CreateGEP(addr, vector<llvm::Value *>{c32(0), c32(0)});
+      addr = cx->Builder.CreateGEP(addr, vector<llvm::Value *>{c32(0), c32(0)});
     }
 
     
     else{
       
-      addr = Builder.CreateGEP(addr, c32(0));
+      addr = cx->Builder.CreateGEP(addr, c32(0));
     }
 
     // id is a variable
@@ -311,39 +325,33 @@ protected:
       
       if (t->isArrayTy()) {
         
-        addr = Builder.CreateGEP(addr, index);
+        addr = cx->Builder.CreateGEP(addr, index);
       }
     }
     return addr;
   }
   // checks if id is the name of a library defined function/proc
-  virtual bool isLibFunc(std::string id) const{
-    return id == "writeInteger" or id == "writeBoolean" or id == "writeReal" or id == "writeChar" or
-             id == "writeString" or id == "readInteger" or id == "readBoolean" or
-             id == "readChar" or id == "readString" or id == "readReal" or
-             id == "abs" or id == "fabs" or id == "sqrt" or id == "sin" or
-             id == "cos" or id == "tan" or id == "arctan" or id == "exp" or
-             id == "ln" or id == "pi" or id == "trunc" or id == "round" or
-             id == "ord" or id == "chr";
+  virtual bool isLibFunc(Name id) const{
+    return id.id() >= NAME_writeInteger and id.id() <= NAME_chr;
   }
   // function that translates symbol table types to llvm types
-  virtual Type *type_to_llvm(Types type, std::string pm = "PASS_BY_VALUE", bool array = false) const {
+  virtual Type *type_to_llvm(Types type, const std::string &pm = "PASS_BY_VALUE", bool array = false) const {
     llvm::Type *llvmtype;
     if (array){
       llvmtype = llvm::ArrayType::get(type_to_llvm(type), 5);
     }
     switch (type) {
       case TYPE_bool:
-        llvmtype = i1;
+        llvmtype = cx->i1;
         break;
       case TYPE_int:
-        llvmtype = i32;
+        llvmtype = cx->i32;
         break;
       case TYPE_char:
-        llvmtype = i8;
+        llvmtype = cx->i8;
         break;
       case TYPE_real:
-      	llvmtype = X86_FP80TyID;
+      	llvmtype = cx->X86_FP80TyID;
       	break;
       case TYPE_array:
       	break;
@@ -357,17 +365,27 @@ protected:
   // dereferencing function
   virtual llvm::Value *deref (llvm::Value *var) const{
     while (var->getType()->getPointerElementType()->isPointerTy())
-      var = Builder.CreateLoad(var);
+      var = cx->Builder.CreateLoad(var);
     return var;
   }
 };
 
+/* ---------------------------------------------------------------------
+   ------------------------------ Type nodes ---------------------------
+   ---------------------------------------------------------------------
+   Type nodes are canonical: there is one Int, Real, Char and Bool per
+   compilation, one Array per element type and size and one Pointer per
+   element type, all made on first use by get() and kept in the
+   compilation (see compilation.hpp). Equal types are the same node, so
+   comparing two types compares two pointers.
+ ----------------------------------------------------------------------- */
+
 class Type_not_from_llvm: public AST{
 public:
   virtual void printOn(std::ostream &out) const override {
     out << "Type()";
   }
-  virtual bool operator==(const Type_not_from_llvm &that) const { return false; }
+  virtual bool operator==(const Type_not_from_llvm &that) const { return this == &that; }
   virtual Types get_type()  {
     return value;
   }
@@ -385,59 +403,80 @@ private:
 
 class Int: public Type_not_from_llvm{
 public:
-  Int(){
-    value = TYPE_int;
+  static Int *get() {
+    Type_not_from_llvm *&t = cx->scalarTypes[TYPE_int];
+    if (!t) t = new Int();
+    return static_cast<Int *>(t);
   }
   virtual Types get_type() override{
     return value;
   }
 private:
+  Int(){
+    value = TYPE_int;
+  }
   Types value;
 };
 
 class Real: public Type_not_from_llvm{
 public:
-  Real(){
-    value = TYPE_real;
+  static Real *get() {
+    Type_not_from_llvm *&t = cx->scalarTypes[TYPE_real];
+    if (!t) t = new Real();
+    return static_cast<Real *>(t);
   }
   virtual Types get_type() override{
     return value;
   }
 private:
+  Real(){
+    value = TYPE_real;
+  }
   Types value;
 };
 
 class Char: public Type_not_from_llvm{
 public:
-  Char(){
-    value = TYPE_char;
+  static Char *get() {
+    Type_not_from_llvm *&t = cx->scalarTypes[TYPE_char];
+    if (!t) t = new Char();
+    return static_cast<Char *>(t);
   }
   virtual Types get_type() override{
     return value;
   }
 private:
+  Char(){
+    value = TYPE_char;
+  }
   Types value;
 };
 
 class Bool: public Type_not_from_llvm{
 public:
-  Bool(){
-    value = TYPE_bool;
+  static Bool *get() {
+    Type_not_from_llvm *&t = cx->scalarTypes[TYPE_bool];
+    if (!t) t = new Bool();
+    return static_cast<Bool *>(t);
   }
   virtual Types get_type() override{
     return value;
   }
 private:
+  Bool(){
+    value = TYPE_bool;
+  }
   Types value;
 };
 
 
 class Array: public Type_not_from_llvm {
 public:
-  Array(Types t, int s = -1){
-    value = TYPE_array;
-    oftype = t;
-    size = s;
+  // s is -1 for an array of unknown size
+  static Array *get(Types t, int s = -1) {
+    Type_not_from_llvm *&a = cx->arrayTypes[std::make_pair(t, s)];
+    if (!a) a = new Array(t, s);
+    return static_cast<Array *>(a);
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Array(size:";
@@ -455,14 +494,7 @@ public:
     s += ")";
     return s;
   }
-  virtual bool operator==(const Array &that) const {
-    if(that.value == TYPE_array){
-      if(oftype == that.oftype && size == that.size) {
-        return true;
-      }
-    }
-    return false;
-  }
+  virtual bool operator==(const Array &that) const { return this == &that; }
   virtual Types get_type() override{
   	return TYPE_array;
   }
@@ -473,6 +505,11 @@ public:
     return oftype;
   }
 private:
+  Array(Types t, int s){
+    value = TYPE_array;
+    oftype = t;
+    size = s;
+  }
   Types value;
   Types oftype;
   int size;
@@ -480,10 +517,10 @@ private:
 
 class Pointer: public Type_not_from_llvm {
 public:
-  Pointer(Types t){
-    value = TYPE_pointer;
-    oftype = t;
-    size = -1;
+  static Pointer *get(Types t) {
+    Type_not_from_llvm *&p = cx->pointerTypes[t];
+    if (!p) p = new Pointer(t);
+    return static_cast<Pointer *>(p);
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Pointer(type:" << oftype << ")";
@@ -495,17 +532,7 @@ public:
     s += ")";
     return s;
   }
-  virtual bool operator==(const Pointer &that) const {
-    if (that.value == TYPE_nil){
-      return true;
-    }
-    if (that.value == TYPE_pointer){
-      if(oftype == that.oftype) {
-        return true;
-      }
-    }
-    return false;
-  }
+  virtual bool operator==(const Pointer &that) const { return this == &that; }
   virtual Types get_type() override{
   	return TYPE_pointer;
   }
@@ -513,6 +540,11 @@ public:
     return oftype;
   }
 private:
+  Pointer(Types t){
+    value = TYPE_pointer;
+    oftype = t;
+    size = -1;
+  }
   Types value;
   Types oftype;
   int size;
@@ -523,8 +555,6 @@ inline std::ostream& operator<<(std::ostream &out, const AST &t) {
   return out;
 }
 
-extern std::vector<int> rt_stack;
-
 class Stmt: public AST {
 public:
   	virtual void printOn(std::ostream &out) const = 0;
@@ -533,11 +563,7 @@ public:
 class Stmtlist: public AST {
 public:
   Stmtlist(): stmt_list(){}
-  ~Stmtlist() {
-    for (Stmt *s : stmt_list) delete s;
-  }
   void append(Stmt* s) { if (s) stmt_list.push_back(s); }
-  void append_first(Stmt* s) {if (s) stmt_list.insert(stmt_list.begin(), s); }
   virtual void printOn(std::ostream &out) const override {
     out << "\nStmtlist(";
     for (Stmt *s : stmt_list) {
@@ -563,29 +589,29 @@ public:
     for (Stmt *s : stmt_list) { s->compile();}
     return nullptr;
   }
-  std::vector<Stmt *> getlist() {
+  const std::vector<Stmt *> &getlist() const {
     return stmt_list;
   }
 private:
   std::vector<Stmt *> stmt_list;
 };
 
+// An expression's type is inferred once, by its sem() (constants know
+// theirs from the start), and stored on the node: get_type() only reads
+// it back, for the checks of the enclosing nodes and for the code
+// generation. The kind is stored as Types, which is all the checks and
+// the code generation branch on; the canonical Pointer and Array nodes
+// are kept as well where their details matter (set_pointer, set_array).
 class Expr: public AST {
 public:
   virtual int eval() const = 0;
-  virtual bool type_check(Types t) {
-    //sem();
-    if (type != t) {
-      return 0;
-    }
-    else {
-      return 1;
-    }
+  bool type_check(Types t) const {
+    return type == t;
   }
-  virtual Types get_type(){
+  Types get_type() const {
     return type;
   }
-  virtual void set_type(Types t) {
+  void set_type(Types t) {
     type = t;
   }
   Pointer *get_pointer(){
@@ -599,30 +625,31 @@ public:
   }
   void set_array(Array *arr){
     a = arr;
-  }                         //                                       _ 0 _
-  // bool isresult(){ //it doesnt work for assign if we have false here  \|/
-  // 	return false;
-  // }
+  }
+  // is it the result of the function being checked?
+  virtual bool isresult() {
+    return false;
+  }
   virtual bool isArElement() {
     return false;
   }
-  virtual std::string get_char_var(){ return "undefined variable/expression"; }
+  // the name of the variable it is (the empty name if it is not one)
+  virtual Name get_char_var(){ return Name(); }
+  // the symbol the variable was resolved to by sem, if it is one
+  virtual Symbol *get_symbol() { return nullptr; }
   virtual Value* get_offset() { return nullptr; }
   virtual Value* compile() const override { return nullptr;}
+protected:
+  Types type = TYPE_error;
 private:
-  Types type;
-  Pointer *p;
-  Array *a;
+  Pointer *p = nullptr;
+  Array *a = nullptr;
 };
 
 class Exprlist: public AST {
 public:
   Exprlist(): exprlist(){}
-  ~Exprlist() {
-    for (Expr *e : exprlist) delete e;
-  }
   void append(Expr *e) { exprlist.push_back(e);}
-  void append_first(Expr *e) { exprlist.insert(exprlist.begin(), e); }
   virtual void printOn(std::ostream &out) const override {
     out << "Exprlist(";
     for (Expr *e : exprlist) {
@@ -641,7 +668,7 @@ public:
     s += ")";
     return s;
   }
-  std::vector<Expr *> getlist() {
+  const std::vector<Expr *> &getlist() const {
     return exprlist;
   }
   std::vector<Value *> get_compiled_list(){
@@ -676,9 +703,6 @@ public:
   virtual int eval() const override {   //unreachable
     return -1;
   }
-  // virtual bool isresult() {
-  //   //return false;
-  // }
 };
 
 class Result: public Lvalue {
@@ -701,36 +725,28 @@ public:
     return s;
   }
   virtual int eval() const override {
-    return rt_stack[offset];
-  }
-  virtual std::string get_char_var() override{
-  	return "@";
-  }
-  virtual Types get_type() override{
-    return TYPE_result;
+    return cx->rt_stack[offset];
   }
-  virtual void set_type(Types t) override {
-  	type = t;
+  virtual Name get_char_var() override{
+  	return NAME_at;
   }
-  virtual bool isresult(){
+  virtual bool isresult() override {
     return true;
   }
   virtual Value* compile() const override {
   	return nullptr;
   }
 private:
-  Types type;
   std::string var;
   int offset;
 };
 
 class BinOp: public Rvalue {
 public:
-  BinOp(Expr *l, char *o, Expr *r): left(l), op(o), right(r) {}
-    ~BinOp() { delete left; delete right; }
+  BinOp(Expr *l, Opcode o, Expr *r): left(l), op(o), right(r) {}
     virtual void printOn(std::ostream &out) const override {
       out << "BinOP(";
-      if (op) out << op;
+      out << op;
       left->printOn(out);
       out << ", ";
       right->printOn(out);
@@ -739,7 +755,7 @@ public:
     virtual std::string getstring() override{
       std::string s = "";
       s += "BinOp(";
-      s += op;
+      s += opName(op);
       s += left->getstring();
       s += ",";
       s += right->getstring();
@@ -747,430 +763,427 @@ public:
       return s;
     }
   virtual int eval() const override {
-    if (! strcmp(op,"+")) return left->eval() + right->eval();
-      if (! strcmp(op,"-")) return left->eval() - right->eval();
-      if (! strcmp(op,"*")) return left->eval() * right->eval();
-      if (! strcmp(op,"/")) return left->eval() / right->eval();
-      if (! strcmp(op,"%")) return left->eval() % right->eval();
-      if (! strcmp(op,"=")) return left->eval() == right->eval();
-      if (! strcmp(op,"<")) return left->eval() < right->eval();
-      if (! strcmp(op,">")) return left->eval() > right->eval();
-      if (! strcmp(op,"<=")) return left->eval() <= right->eval();
-      if (! strcmp(op,">=")) return left->eval() >= right->eval();
-      if (! strcmp(op,"<>")) return left->eval() != right->eval();
-      if (! strcmp(op,"div")) return left->eval() / right->eval();
-      if (! strcmp(op,"mod")) return left->eval() % right->eval();
-      if (! strcmp(op,"or")) return left->eval() || right->eval();
-      if (! strcmp(op,"and")) return left->eval() && right->eval();
-      return 0;  // this will never be reached.
-    }
-  virtual Types get_type() override {
-  	return t;
-  }
-  virtual bool type_check(Types t_given) override {
-    //sem();
-    if (t != t_given) {
-      return 0;
+    switch (op) {
+      case OP_add: return left->eval() + right->eval();
+      case OP_sub: return left->eval() - right->eval();
+      case OP_mul: return left->eval() * right->eval();
+      case OP_div: return left->eval() / right->eval();
+      case OP_eq: return left->eval() == right->eval();
+      case OP_lt: return left->eval() < right->eval();
+      case OP_gt: return left->eval() > right->eval();
+      case OP_le: return left->eval() <= right->eval();
+      case OP_ge: return left->eval() >= right->eval();
+      case OP_neq: return left->eval() != right->eval();
+      case OP_intdiv: return left->eval() / right->eval();
+      case OP_mod: return left->eval() % right->eval();
+      case OP_or: return left->eval() || right->eval();
+      case OP_and: return left->eval() && right->eval();
+      default: return 0;  // this will never be reached.
     }
-    else {
-      return 1;
     }
-  }
   virtual void sem() override {
       left->sem();
       right->sem();
 
-      if (left->get_type() == TYPE_result){
-        left->set_type(st.lookup("result")->type);
+      // an operand that failed to check has been reported already
+      if (left->get_type() == TYPE_error || right->get_type() == TYPE_error){
+        type = TYPE_error;
+        return;
       }
 
-      if (right->get_type() == TYPE_result){
-        right->set_type(st.lookup("result")->type);
-      }
-
-      if ((! strcmp(op,"+")) || (!strcmp(op,"-")) || (!strcmp(op,"*"))){ //make sure both operands have the same "number type" 
-      	std::string l_s = left->get_char_var();
-        std::string r_s = right->get_char_var();
-      	if (st.foundFunc(l_s) || st.foundFunc(r_s)){
-      		std::cerr << "ERROR: Cannot perform arithmetic expressions on functions\n";
-      		exit(1);
+      switch (op) {
+      case OP_add: case OP_sub: case OP_mul: { //make sure both operands have the same "number type" 
+      	Name l_s = left->get_char_var();
+        Name r_s = right->get_char_var();
+      	if (cx->st.foundFunc(l_s) || cx->st.foundFunc(r_s)){
+      		diag().error() << "ERROR: Cannot perform arithmetic expressions on functions\n";
+      		type = TYPE_error;
+      		return;
       	}
-      	if (st.foundProc(l_s) || st.foundProc(r_s)){
-      		std::cerr << "ERROR: Cannot perform arithmetic expressions on procedures\n";
-      		exit(1);
+      	if (cx->st.foundProc(l_s) || cx->st.foundProc(r_s)){
+      		diag().error() << "ERROR: Cannot perform arithmetic expressions on procedures\n";
+      		type = TYPE_error;
+      		return;
       	}
         if (left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-            t = TYPE_int;
-            type = new Int();
+            type = TYPE_int;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else if (left->get_type() == TYPE_int && right->get_type() == TYPE_real){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_int){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else {
-          std::cerr << "ERROR: Type mismatch for BinOp " << op << std::endl;
-          exit(1);
+          diag().error() << "ERROR: Type mismatch for BinOp " << op << std::endl;
+          type = TYPE_error;
+          return;
         }
+        break;
       }
-      if (! strcmp(op,"/")) //make sure that left and right are numbers (ints or reals)
-      {
-      	std::string l_s = left->get_char_var();
-        std::string r_s = right->get_char_var();
-      	if (st.foundFunc(l_s) || st.foundFunc(r_s)){
-      		std::cerr << "ERROR: Cannot perform arithmetic expressions on functions\n";
-      		exit(1);
+      case OP_div: { //make sure that left and right are numbers (ints or reals)
+      	Name l_s = left->get_char_var();
+        Name r_s = right->get_char_var();
+      	if (cx->st.foundFunc(l_s) || cx->st.foundFunc(r_s)){
+      		diag().error() << "ERROR: Cannot perform arithmetic expressions on functions\n";
+      		type = TYPE_error;
+      		return;
       	}
-      	if (st.foundProc(l_s) || st.foundProc(r_s)){
-      		std::cerr << "ERROR: Cannot perform arithmetic expressions on procedures\n";
-      		exit(1);
+      	if (cx->st.foundProc(l_s) || cx->st.foundProc(r_s)){
+      		diag().error() << "ERROR: Cannot perform arithmetic expressions on procedures\n";
+      		type = TYPE_error;
+      		return;
       	}
         if (left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else if (left->get_type() == TYPE_int && right->get_type() == TYPE_real){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_int){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         else {
-          std::cerr << "ERROR: Type mismatch for BinOp " << op << std::endl;
-          exit(1);
+          diag().error() << "ERROR: Type mismatch for BinOp " << op << std::endl;
+          type = TYPE_error;
+          return;
         }
+        break;
       }
-      if ((! strcmp(op,"mod")) || (!strcmp(op,"div"))){
+      case OP_mod: case OP_intdiv: {
         if (left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          t = TYPE_int;
-          type = new Int();
+          type = TYPE_int;
         }
         else {
-            std::cerr << "ERROR: Type mismatch for BinOp " << op << std::endl;
-            exit(1);
+            diag().error() << "ERROR: Type mismatch for BinOp " << op << std::endl;
+            type = TYPE_error;
+            return;
           }
+        break;
       }
-      if ((! strcmp(op,"<")) || (!strcmp(op,">")) || (!strcmp(op,"<=")) || (!strcmp(op,">="))){ //both operands must be numbers
-      	std::string l_s = left->get_char_var();
-        std::string r_s = right->get_char_var();
-      	if (st.foundFunc(l_s) || st.foundFunc(r_s)){
-      		std::cerr << "ERROR: Cannot perform boolean expressions on functions\n";
-      		exit(1);
+      case OP_lt: case OP_gt: case OP_le: case OP_ge: { //both operands must be numbers
+      	Name l_s = left->get_char_var();
+        Name r_s = right->get_char_var();
+      	if (cx->st.foundFunc(l_s) || cx->st.foundFunc(r_s)){
+      		diag().error() << "ERROR: Cannot perform boolean expressions on functions\n";
+      		type = TYPE_error;
+      		return;
       	}
-      	if (st.foundProc(l_s) || st.foundProc(r_s)){
-      		std::cerr << "ERROR: Cannot perform boolean expressions on procedures\n";
-      		exit(1);
+      	if (cx->st.foundProc(l_s) || cx->st.foundProc(r_s)){
+      		diag().error() << "ERROR: Cannot perform boolean expressions on procedures\n";
+      		type = TYPE_error;
+      		return;
       	}
         if (left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if (left->get_type() == TYPE_int && right->get_type() == TYPE_real){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_int){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else {
-          std::cerr << "ERROR: Type mismatch for BinOp " << op << std::endl;
-          exit(1);
+          diag().error() << "ERROR: Type mismatch for BinOp " << op << std::endl;
+          type = TYPE_error;
+          return;
         } 
+        break;
       }
-      if ((! strcmp(op,"=")) || (!strcmp(op,"<>"))){ //opernads must be both numbers or of the same type but not arrays
-      	std::string l_s = left->get_char_var();
-        std::string r_s = right->get_char_var();
-      	if (st.foundFunc(l_s) || st.foundFunc(r_s)){
-      		std::cerr << "ERROR: Cannot perform boolean expressions on functions\n";
-      		exit(1);
+      case OP_eq: case OP_neq: { //opernads must be both numbers or of the same type but not arrays
+      	Name l_s = left->get_char_var();
+        Name r_s = right->get_char_var();
+      	if (cx->st.foundFunc(l_s) || cx->st.foundFunc(r_s)){
+      		diag().error() << "ERROR: Cannot perform boolean expressions on functions\n";
+      		type = TYPE_error;
+      		return;
       	}
-      	if (st.foundProc(l_s) || st.foundProc(r_s)){
-      		std::cerr << "ERROR: Cannot perform boolean expressions on procedures\n";
-      		exit(1);
+      	if (cx->st.foundProc(l_s) || cx->st.foundProc(r_s)){
+      		diag().error() << "ERROR: Cannot perform boolean expressions on procedures\n";
+      		type = TYPE_error;
+      		return;
       	}
         if (left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if (left->get_type() == TYPE_int && right->get_type() == TYPE_real){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if (left->get_type() == TYPE_real && right->get_type() == TYPE_int){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else if ((left->get_type() == right->get_type()) && (left->get_type() != TYPE_array)){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
         else {
-          std::cerr << "ERROR: Type mismatch for BinOp " << op << std::endl;
-          exit(1);
+          diag().error() << "ERROR: Type mismatch for BinOp " << op << std::endl;
+          type = TYPE_error;
+          return;
         }
+        break;
       }
-      if ((! strcmp(op,"or")) || (!strcmp(op,"and"))){ //operands must be both booleans
-      	std::string l_s = left->get_char_var();
-        std::string r_s = right->get_char_var();
-      	if (st.foundFunc(l_s) || st.foundFunc(r_s)){
-      		std::cerr << "ERROR: Cannot perform boolean expressions on functions\n";
-      		exit(1);
+      case OP_or: case OP_and: { //operands must be both booleans
+      	Name l_s = left->get_char_var();
+        Name r_s = right->get_char_var();
+      	if (cx->st.foundFunc(l_s) || cx->st.foundFunc(r_s)){
+      		diag().error() << "ERROR: Cannot perform boolean expressions on functions\n";
+      		type = TYPE_error;
+      		return;
       	}
-      	if (st.foundProc(l_s) || st.foundProc(r_s)){
-      		std::cerr << "ERROR: Cannot perform boolean expressions on procedures\n";
-      		exit(1);
+      	if (cx->st.foundProc(l_s) || cx->st.foundProc(r_s)){
+      		diag().error() << "ERROR: Cannot perform boolean expressions on procedures\n";
+      		type = TYPE_error;
+      		return;
       	}
         if (left->get_type() == TYPE_bool && right->get_type() == TYPE_bool){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
+        break;
+      }
+      default: break;
       }
     }
   virtual Value* compile() const override {
       Value *l = left->compile();
       Value *r = right->compile();
+      Types lt = left->get_type();
+      Types rt = right->get_type();
 
-      if (! strcmp(op,"+")){
-        if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_real)) {
-        	return Builder.CreateFAdd(l, r, "addftmp");
+      switch (op) {
+      case OP_add: {
+        if((lt == TYPE_real) && (rt == TYPE_real)) {
+        	return cx->Builder.CreateFAdd(l, r, "addftmp");
         }
-        if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_int)){
-        	Value *nr = Builder.CreateUIToFP(r, X86_FP80TyID, "ext");
-        	return Builder.CreateFAdd(l, nr, "addftmp");	
+        if((lt == TYPE_real) && (rt == TYPE_int)){
+        	Value *nr = cx->Builder.CreateUIToFP(r, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFAdd(l, nr, "addftmp");	
         }
-        if((left->get_type() == TYPE_int) && (right->get_type() == TYPE_real)){
-        	Value *nl = Builder.CreateUIToFP(l, X86_FP80TyID, "ext");
-        	return Builder.CreateFAdd(nl, r, "addftmp");	
+        if((lt == TYPE_int) && (rt == TYPE_real)){
+        	Value *nl = cx->Builder.CreateUIToFP(l, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFAdd(nl, r, "addftmp");	
         }
-        return Builder.CreateAdd(l, r, "addtmp");
+        return cx->Builder.CreateAdd(l, r, "addtmp");
       }
-      if (! strcmp(op,"-")){
-        if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_real)) {
-        	return Builder.CreateFSub(l, r, "subftmp");
+      case OP_sub: {
+        if((lt == TYPE_real) && (rt == TYPE_real)) {
+        	return cx->Builder.CreateFSub(l, r, "subftmp");
         }
-        if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_int)){
-        	Value *nr = Builder.CreateUIToFP(r, X86_FP80TyID, "ext");
-        	return Builder.CreateFSub(l, nr, "subftmp");	
+        if((lt == TYPE_real) && (rt == TYPE_int)){
+        	Value *nr = cx->Builder.CreateUIToFP(r, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFSub(l, nr, "subftmp");	
         }
-        if((left->get_type() == TYPE_int) && (right->get_type() == TYPE_real)){
-        	Value *nl = Builder.CreateUIToFP(l, X86_FP80TyID, "ext");
-        	return Builder.CreateFSub(nl, r, "subftmp");	
+        if((lt == TYPE_int) && (rt == TYPE_real)){
+        	Value *nl = cx->Builder.CreateUIToFP(l, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFSub(nl, r, "subftmp");	
         }
-        return Builder.CreateSub(l, r, "subtmp");
+        return cx->Builder.CreateSub(l, r, "subtmp");
       }
-      if (! strcmp(op,"*")){
-        if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_real)) {
-        	return Builder.CreateFMul(l, r, "mulftmp");
+      case OP_mul: {
+        if((lt == TYPE_real) && (rt == TYPE_real)) {
+        	return cx->Builder.CreateFMul(l, r, "mulftmp");
         }
-        if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_int)){
-        	Value *nr = Builder.CreateUIToFP(r, X86_FP80TyID, "ext");
-        	return Builder.CreateFMul(l, nr, "mulftmp");	
+        if((lt == TYPE_real) && (rt == TYPE_int)){
+        	Value *nr = cx->Builder.CreateUIToFP(r, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFMul(l, nr, "mulftmp");	
         }
-        if((left->get_type() == TYPE_int) && (right->get_type() == TYPE_real)){
-        	Value *nl = Builder.CreateUIToFP(l, X86_FP80TyID, "ext");
-        	return Builder.CreateFMul(nl, r, "mulftmp");	
+        if((lt == TYPE_int) && (rt == TYPE_real)){
+        	Value *nl = cx->Builder.CreateUIToFP(l, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFMul(nl, r, "mulftmp");	
         }
-        return Builder.CreateMul(l, r, "multmp");
+        return cx->Builder.CreateMul(l, r, "multmp");
       }
-      if (! strcmp(op, "/")) {
-      	if((left->get_type() == TYPE_int) && (right->get_type() == TYPE_int)) {
-        	Value *nr = Builder.CreateUIToFP(r, X86_FP80TyID, "ext");
-        	Value *nl = Builder.CreateUIToFP(l, X86_FP80TyID, "ext");
-        	return Builder.CreateFMul(nl, nr, "mulftmp");
+      case OP_div: {
+      	if((lt == TYPE_int) && (rt == TYPE_int)) {
+        	Value *nr = cx->Builder.CreateUIToFP(r, cx->X86_FP80TyID, "ext");
+        	Value *nl = cx->Builder.CreateUIToFP(l, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFMul(nl, nr, "mulftmp");
         }
-      	if((left->get_type() == TYPE_real) && (right->get_type() == TYPE_int)){
-        	Value *nr = Builder.CreateUIToFP(r, X86_FP80TyID, "ext");
-        	return Builder.CreateFDiv(l, nr, "divftmp");	
+      	if((lt == TYPE_real) && (rt == TYPE_int)){
+        	Value *nr = cx->Builder.CreateUIToFP(r, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFDiv(l, nr, "divftmp");	
         }
-        if((left->get_type() == TYPE_int) && (right->get_type() == TYPE_real)){
-        	Value *nl = Builder.CreateUIToFP(l, X86_FP80TyID, "ext");
-        	return Builder.CreateFDiv(nl, r, "divftmp");	
+        if((lt == TYPE_int) && (rt == TYPE_real)){
+        	Value *nl = cx->Builder.CreateUIToFP(l, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFDiv(nl, r, "divftmp");	
         }
-      	return Builder.CreateFDiv(l, r, "divftmp");
+      	return cx->Builder.CreateFDiv(l, r, "divftmp");
+        break;
       }
-      if (! strcmp(op, "=")){
-        if(left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          return Builder.CreateFCmpOEQ(l, r, "feqtmp"); // OEQ = ordered
+      case OP_eq: {
+        if(lt == TYPE_real && rt == TYPE_real){
+          return cx->Builder.CreateFCmpOEQ(l, r, "feqtmp"); // OEQ = ordered
         }
-        else if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
+        else if(lt == TYPE_int && rt == TYPE_int){
           // Value *v = Builder.CreateICmpEQ(l, r, "eqtmp");
           // v->print(errs());
-          return Builder.CreateICmpEQ(l, r, "eqtmp");
+          return cx->Builder.CreateICmpEQ(l, r, "eqtmp");
         }
-        else if ((left->get_type() == TYPE_int) && (right->get_type() == TYPE_real)){
-        	Value *nr = Builder.CreateUIToFP(r, X86_FP80TyID, "ext");
-        	return Builder.CreateFCmpOEQ(l, nr, "feqtmp");
+        else if ((lt == TYPE_int) && (rt == TYPE_real)){
+        	Value *nr = cx->Builder.CreateUIToFP(r, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFCmpOEQ(l, nr, "feqtmp");
         }
-        else if ((left->get_type() == TYPE_real) && (right->get_type() == TYPE_int)){
-        	Value *nl = Builder.CreateUIToFP(l, X86_FP80TyID, "ext");
-        	return Builder.CreateFCmpOEQ(nl, r, "feqtmp");
+        else if ((lt == TYPE_real) && (rt == TYPE_int)){
+        	Value *nl = cx->Builder.CreateUIToFP(l, cx->X86_FP80TyID, "ext");
+        	return cx->Builder.CreateFCmpOEQ(nl, r, "feqtmp");
         }
+        break;
       }
-      if (! strcmp(op, "<")){
-        if(left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          return Builder.CreateFCmpOLT(l, r, "flttmp"); // less than
+      case OP_lt: {
+        if(lt == TYPE_real && rt == TYPE_real){
+          return cx->Builder.CreateFCmpOLT(l, r, "flttmp"); // less than
         }
-        else if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          return Builder.CreateICmpSLT(l, r, "lttmp");
+        else if(lt == TYPE_int && rt == TYPE_int){
+          return cx->Builder.CreateICmpSLT(l, r, "lttmp");
         }
+        break;
       }
-      if (! strcmp(op, ">")){
-        if(left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          return Builder.CreateFCmpOGT(l, r, "fgttmp"); // greater than
+      case OP_gt: {
+        if(lt == TYPE_real && rt == TYPE_real){
+          return cx->Builder.CreateFCmpOGT(l, r, "fgttmp"); // greater than
         }
-        else if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          return Builder.CreateICmpSGT(l, r, "gttmp");
+        else if(lt == TYPE_int && rt == TYPE_int){
+          return cx->Builder.CreateICmpSGT(l, r, "gttmp");
         }
+        break;
       }
-      if (! strcmp(op, "<=")){
-        if(left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          return Builder.CreateFCmpOLE(l, r, "fletmp"); // O = ordered
+      case OP_le: {
+        if(lt == TYPE_real && rt == TYPE_real){
+          return cx->Builder.CreateFCmpOLE(l, r, "fletmp"); // O = ordered
         }
-        else if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          return Builder.CreateICmpSLE(l, r, "letmp");
+        else if(lt == TYPE_int && rt == TYPE_int){
+          return cx->Builder.CreateICmpSLE(l, r, "letmp");
         }
+        break;
       }
-      if (! strcmp(op, ">=")){
-        if(left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          return Builder.CreateFCmpOGE(l, r, "fgetmp"); // OEQ = ordered
+      case OP_ge: {
+        if(lt == TYPE_real && rt == TYPE_real){
+          return cx->Builder.CreateFCmpOGE(l, r, "fgetmp"); // OEQ = ordered
         }
-        else if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          return Builder.CreateICmpSGE(l, r, "getmp");
+        else if(lt == TYPE_int && rt == TYPE_int){
+          return cx->Builder.CreateICmpSGE(l, r, "getmp");
         }
+        break;
       }
-      if (! strcmp(op, "<>")){
-        if(left->get_type() == TYPE_real && right->get_type() == TYPE_real){
-          return Builder.CreateFCmpONE(l, r, "fnetmp"); // OEQ = ordered
+      case OP_neq: {
+        if(lt == TYPE_real && rt == TYPE_real){
+          return cx->Builder.CreateFCmpONE(l, r, "fnetmp"); // OEQ = ordered
         }
-        else if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-          return Builder.CreateICmpNE(l, r, "netmp");
+        else if(lt == TYPE_int && rt == TYPE_int){
+          return cx->Builder.CreateICmpNE(l, r, "netmp");
         }
+        break;
       }
-      if (! strcmp(op, "div")) return Builder.CreateSDiv(l, r, "divtmp");
-      if (! strcmp(op, "mod")) {
-      	if(left->get_type() == TYPE_int && right->get_type() == TYPE_int){
-      		return Builder.CreateSRem(l, r, "modtmp");
+      case OP_intdiv: return cx->Builder.CreateSDiv(l, r, "divtmp");
+      case OP_mod: {
+      	if(lt == TYPE_int && rt == TYPE_int){
+      		return cx->Builder.CreateSRem(l, r, "modtmp");
       	}
-      	return Builder.CreateSRem(l, r, "modtmp");
+      	return cx->Builder.CreateSRem(l, r, "modtmp");
+      }
+      case OP_or: return cx->Builder.CreateOr(l, r, "ortmp");
+      case OP_and: return cx->Builder.CreateAnd(l, r, "andtmp");
+      default: break;
       }
-      if (! strcmp(op, "or")) return Builder.CreateOr(l, r, "ortmp");
-      if (! strcmp(op, "and")) return Builder.CreateAnd(l, r, "andtmp");
       return nullptr;
     }
 private:
-  Types t;
-  Type_not_from_llvm *type;
   Expr *left;
-  char *op;
+  Opcode op;
   Expr *right;
 };
 
 class UnOp: public Rvalue
 {
 public:
-  UnOp(char *o, Expr *r): op(o), right(r) {}
-  ~UnOp() {delete right; } 
+  UnOp(Opcode o, Expr *r): op(o), right(r) {}
   virtual void printOn(std::ostream &out) const override {
     out << "UnOp(";
-    if (op) out << op << ",";
+    out << op << ",";
     right->printOn(out);
     out << ")";
   }
   virtual std::string getstring() override{
       std::string s = "";
       s += "UnOp(";
-      s += op;
+      s += opName(op);
       s += right->getstring();
       s += ")";
       return s;
     }
     virtual int eval() const override {
-      if (! strcmp(op,"+")) return right->eval();
-      if (! strcmp(op,"-")) return -right->eval();
-      if (! strcmp(op,"not")) return !right->eval();
-      return 0; //this will never be reached
-    }
-    virtual Types get_type() override {
-    	return t;
+      switch (op) {
+        case OP_add: return right->eval();
+        case OP_sub: return -right->eval();
+        case OP_not: return !right->eval();
+        default: return 0; //this will never be reached
+      }
     }
     virtual void sem() override {
       right->sem();
 
-      if (right->get_type() == TYPE_result){
-        right->set_type(st.lookup("result")->type);
-      }
-
-      if ((! strcmp(op,"+")) || (!strcmp(op,"-"))){ //operand must be number. result same type as number
+      switch (op) {
+      case OP_add: case OP_sub: { //operand must be number. result same type as number
         if (right->type_check(TYPE_real)){
-          t = TYPE_real;
-          type = new Real();
+          type = TYPE_real;
         }
         if (right->type_check(TYPE_int)){
-          t = TYPE_int;
-          type = new Int();
+          type = TYPE_int;
         }
         else {
           std::cerr << "Type mismatch for UnOp " << op << std::endl;
         }
+        break;
       }
-      if (! strcmp(op,"not")) { //operand must be boolean
+      case OP_not: { //operand must be boolean
         if (right->get_type() == TYPE_bool){
-          t = TYPE_bool;
-          type = new Bool();
+          type = TYPE_bool;
         }
+        break;
+      }
+      default: break;
       }
     }
     virtual Value* compile() const override { 
     	Value *r = right->compile();    	
-    	if (! strcmp(op,"+")) return r;
-    	if (! strcmp(op,"-")) {
+    	switch (op) {
+    	case OP_add: return r;
+    	case OP_sub: {
     		
-    		if (right->type_check(TYPE_int)){
+    		if (right->get_type() == TYPE_int){
     			Value *l = c32(-1);
-    			return Builder.CreateMul(l, r, "multmp");
+    			return cx->Builder.CreateMul(l, r, "multmp");
     		}
-    		else if (right->type_check(TYPE_real)){
+    		else if (right->get_type() == TYPE_real){
     			Value *l = fp32(-1.0);
-    			return Builder.CreateFMul(l, r, "addftmp");
+    			return cx->Builder.CreateFMul(l, r, "addftmp");
     		}
+    		break;
+    	}
+    	case OP_not: return cx->Builder.CreateNot(r, "not");
+    	default: break;
     	}
-    	if (! strcmp(op,"not")){
-    		return Builder.CreateNot(r, "not");
-    	} 
     	return nullptr;
     }
 private:
-	Types t;
-  Type_not_from_llvm *type;
-  char *op;
+  Opcode op;
   Expr *right;  
 };
 
 class Id: public Lvalue {
 public:
-  Id(std::string v) {var = v; offset = -1; }
+  Id(Name v) {var = v; offset = -1; sym = nullptr; }
   virtual void printOn(std::ostream &out) const override {
     out << "Id(" << var << " with offset " << offset << ")";
   }
@@ -1182,39 +1195,30 @@ public:
     return s;
   }
   virtual int eval() const override {
-    return rt_stack[offset];
+    return cx->rt_stack[offset];
   }
-  virtual std::string get_char_var() override{
+  virtual Name get_char_var() override{
   	return var;
   }
-  virtual Types get_type() override{
-  	return type;
-  }
-  virtual bool type_check(Types t) override{
-    //sem();
-    if (type != t) {
-      return 0;
-    }
-    else {
-      return 1;
-    }
-  }
   virtual bool isresult(){
     return false;
   }
+  virtual Symbol *get_symbol() override {
+    return sym;
+  }
   virtual void sem() override {
-    type = st.lookup(var)->type;
-    SymbolEntry *en = st.lookup(var);
-    offset = en->offset;
+    sym = cx->st.lookupSymbol(var);
+    type = sym->entry.type;
+    offset = sym->entry.offset;
   }
   virtual Value* compile() const override {
-    return Builder.CreateLoad(calcAddr(var, "Id"));
+    return cx->Builder.CreateLoad(calcAddr(var, "Id", nullptr, sym));
   }
 
 private:
-  Types type;
-  std::string var;
+  Name var;
   int offset;
+  Symbol *sym;
 };
 
 class ArElement: public Lvalue {
@@ -1243,8 +1247,8 @@ public:
   virtual bool isresult(){
     return false;
   }
-  virtual std::string get_char_var() override{
-  	std::string id = lvalue->get_char_var();
+  virtual Name get_char_var() override{
+  	Name id = lvalue->get_char_var();
   	return id;
   }
   virtual Value * get_offset() override{
@@ -1254,41 +1258,36 @@ public:
   virtual bool isArElement() override{
     return true;
   }
-  virtual Types get_type() override {
-  	std::string s = lvalue->get_char_var();
-  	return st.getArrayType(s);
+  virtual Symbol *get_symbol() override {
+    return lvalue->get_symbol();
   }
   virtual void sem() override {
     lvalue->sem();
     expr->sem();
 
-    if (lvalue->get_type() == TYPE_result) {
-      lvalue->set_type(st.lookup("result")->type);
-    }
-
-    if (expr->get_type() == TYPE_result){
-      expr->set_type(st.lookup("result")->type);
-    }
     if (lvalue->get_type() != TYPE_array){
-      printOn(std::cerr);
+      printOn(diag().error());
       std::cerr << " is not of type array!\n\n";
-      exit(1);
+      type = TYPE_error;
+      return;
     }
     else {
       if (expr->get_type() != TYPE_int) {
-        printOn(std::cerr);
+        printOn(diag().error());
         std::cerr << " [] expr is not an integer\n";
-        exit(1);
+        type = TYPE_error;
+        return;
       }
     }
+    // the element type, resolved while the array is still in scope
+    Symbol *sym = lvalue->get_symbol();
+    type = sym ? sym->arrayType : cx->st.getArrayType(lvalue->get_char_var());
   }
   virtual Value* compile() const override { 
-    std::string s = lvalue->get_char_var();
-    return Builder.CreateLoad(calcAddr(s, "ArElement", expr->compile()));
+    Name s = lvalue->get_char_var();
+    return cx->Builder.CreateLoad(calcAddr(s, "ArElement", expr->compile(), lvalue->get_symbol()));
   }
 private:
-  Types consttype;
-  Type_not_from_llvm *type;
   Expr *lvalue;
   Expr *expr;
 };
@@ -1297,7 +1296,6 @@ class Reference: public Rvalue {
 public:
   Reference (Expr *l){
     lvalue = l;
-    type = nullptr;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Reference(";
@@ -1317,19 +1315,15 @@ public:
   virtual void sem() override {
     lvalue->sem();
 
-    if (lvalue->get_type() == TYPE_result) {
-      lvalue->set_type(st.lookup("result")->type);
-    }
-
-    type = new Pointer(lvalue->get_type());
+    type = TYPE_pointer;
+    set_pointer(Pointer::get(lvalue->get_type()));
   }
   virtual Value* compile() const override { 
     
-  	std::string s = lvalue->get_char_var();
-    return Builder.CreateLoad(calcAddr(s,"Reference", nullptr));
+  	Name s = lvalue->get_char_var();
+    return cx->Builder.CreateLoad(calcAddr(s,"Reference", nullptr));
   }
 private:
-  Type_not_from_llvm *type;
   Expr *lvalue;
 };
 
@@ -1358,38 +1352,24 @@ public:
   }
   virtual void sem() override {
     expr->sem();
-    
-    if (expr->get_type() == TYPE_result) {
-      expr->set_type(st.lookup("result")->type);
-    }
 
     if (!(expr->get_type() == TYPE_pointer)){
-      printOn(std::cerr);
+      printOn(diag().error());
       std::cerr << "Only pointer type can be dereferenced!\n";
       std::cerr << "expression is of type " << expr->get_type();
-      exit(1);
-    }
-    consttype = expr->get_pointer()->get_oftype();
-    if (consttype == TYPE_int){
-      type = new Int();
-    }
-    if (consttype == TYPE_bool){
-      type = new Bool();
-    }
-    if (consttype == TYPE_real){
-      type = new Real();
+      type = TYPE_error;
+      return;
     }
-    if (consttype == TYPE_char){
-      type = new Char();
+    Types consttype = expr->get_pointer()->get_oftype();
+    if (consttype == TYPE_int || consttype == TYPE_bool || consttype == TYPE_real || consttype == TYPE_char){
+      type = consttype;
     }
   }
   virtual Value* compile() const override {
-    std::string s = expr->get_char_var();
-    return Builder.CreateLoad(calcAddr(s,"Dereference", nullptr));
+    Name s = expr->get_char_var();
+    return cx->Builder.CreateLoad(calcAddr(s,"Dereference", nullptr));
   }
 private:
-  Types consttype;
-  Type_not_from_llvm *type;
   Expr *expr;
 };
 
@@ -1418,78 +1398,79 @@ public:
   virtual void sem() override { //sth for result types
     lvalue->sem();
     expr->sem();
-    if (lvalue->get_type() == TYPE_result){
-      if(!st.foundResult()){
-        st.insert("result", expr->get_type());
+    if (lvalue->isresult()){
+      if(!cx->st.foundResult()){
+        cx->st.insert(NAME_result, expr->get_type());
       }
 
-      std::string fname = st.getParent();
-      Types ftype = st.lookup(fname)->type;
+      Name fname = cx->st.getParent();
+      Types ftype = cx->st.lookup(fname)->type;
       if(ftype == TYPE_proc){
-        std::cerr << "ERROR: A procedure cannot return a result (" << fname << ")\n"; 
-        exit(1);
+        diag().error() << "ERROR: A procedure cannot return a result (" << fname << ")\n"; 
+        return;
       }
 
       Types resType = expr->get_type();
       if (resType == TYPE_array){
-       std::cerr << "ERROR: Result cannot be of type Array (" << fname <<")";
-       exit(1);
+       diag().error() << "ERROR: Result cannot be of type Array (" << fname <<")";
+       return;
       }
 
       if(!(resType == ftype)){
-       std::cerr << "ERROR: Type mismatch! " << fname << " is of type " << ftype << " but its result is of type " << resType;
-       exit(1);
+       diag().error() << "ERROR: Type mismatch! " << fname << " is of type " << ftype << " but its result is of type " << resType;
+       return;
       }
       lvalue->set_type(resType);
     }
     else{
       //not result
-    	std::string s = lvalue->get_char_var();
+    	Name s = lvalue->get_char_var();
     	// std::string r_s = expr->get_char_var();
-    	if (st.foundFunc(s)){
-    	  std::cerr << "ERROR: Assign Type Missmatch in Expression:\n";
+    	if (cx->st.foundFunc(s)){
+    	  diag().error() << "ERROR: Assign Type Missmatch in Expression:\n";
           std::cerr << lvalue->get_char_var() << " := " << expr->get_char_var() << "\n";
           std::cerr << lvalue->get_char_var() << " is of type Function!\n";
-          exit(1);
+          return;
     	}
-    	if (st.foundProc(s)){
-    	  std::cerr << "ERROR: Assign Type Missmatch in Expression:\n";
+    	if (cx->st.foundProc(s)){
+    	  diag().error() << "ERROR: Assign Type Missmatch in Expression:\n";
           std::cerr << lvalue->get_char_var() << " := " << expr->get_char_var() << "\n";
           std::cerr << lvalue->get_char_var() << " is of type Procedure!\n";
-          exit(1);
+          return;
     	}
     	// st.lookup(s);
     	// st.lookup(r_s);
+      if (expr->get_type() == TYPE_error || lvalue->get_type() == TYPE_error) return;
       if (expr->get_type() != lvalue->get_type()) //{offset = lhs->offset;} //check again
       { 
       	// std::cout << expr->get_type();
       	// std::cout << lvalue->get_type();
-        std::cerr << "ERROR: Type Missmatch in assignment\n";
+        diag().error() << "ERROR: Type Missmatch in assignment\n";
         // printOn(std::cerr);
         // std::cerr << s << " := " << r_s << "\n";
-        exit(1);
+        return;
       }
       }
   }
   virtual Value* compile() const override {
     
-    std::string s = lvalue->get_char_var();
+    Name s = lvalue->get_char_var();
     auto *right = expr->compile();
-    if (s.compare("@") == 0){ // we have a result to return
-      auto *addr = calcAddr("result", "Assign", nullptr);
-      return Builder.CreateStore(right,addr);
+    if (s == NAME_at){ // we have a result to return
+      auto *addr = calcAddr(NAME_result, "Assign", nullptr);
+      return cx->Builder.CreateStore(right,addr);
     }
     if (lvalue->isArElement()){
       
       auto *index = lvalue->get_offset();
       
-      auto *addr = calcAddr(s, "Assign", index);
-      return Builder.CreateStore(right,addr);  
+      auto *addr = calcAddr(s, "Assign", index, lvalue->get_symbol());
+      return cx->Builder.CreateStore(right,addr);  
     }
     
-    auto *addr = calcAddr(s, "Assign", nullptr);
+    auto *addr = calcAddr(s, "Assign", nullptr, lvalue->get_symbol());
 
-    return Builder.CreateStore(right,addr);
+    return cx->Builder.CreateStore(right,addr);
   }
 private:
   Expr *expr;
@@ -1508,13 +1489,13 @@ public:
     return s;
   }
   virtual Value* compile() const override {
-    llvm::BasicBlock * currentBlock = Builder.GetInsertBlock();
-    std::string fname = loggedinfo.getLastFunc();
-    llvm::BasicBlock * endfunc = loggedinfo.getEndOfFunc(fname);
+    llvm::BasicBlock * currentBlock = cx->Builder.GetInsertBlock();
+    Name fname = cx->loggedinfo.getLastFunc();
+    llvm::BasicBlock * endfunc = cx->loggedinfo.getEndOfFunc(fname);
     llvm::Function *F = currentBlock->getParent();
-    llvm::BasicBlock * succ = llvm::BasicBlock::Create(TheContext, "succ", F);
-    Builder.CreateBr(succ);
-    Builder.SetInsertPoint(succ);
+    llvm::BasicBlock * succ = llvm::BasicBlock::Create(cx->TheContext, "succ", F);
+    cx->Builder.CreateBr(succ);
+    cx->Builder.SetInsertPoint(succ);
     succ->moveBefore(endfunc);
     return nullptr;
   }
@@ -1526,43 +1507,41 @@ public:
   Id_list(): id_list(){ }
   virtual void printOn(std::ostream &out) const override {
     out << "Idlist(";
-    for (std::string id : id_list) {
+    for (Name id : id_list) {
       out << id;
       out << ", ";
     }
     out << ")";
   }
-  void append_char(std::string str) {
+  void append_char(Name str) {
     id_list.push_back(str);
   }
-  void append_first(std::string i) { id_list.insert(id_list.begin(), i); }
   virtual std::string getstring() override {
     std::string s = "";
     s += "Idlist(";
-    for (std::string id : id_list) {
+    for (Name id : id_list) {
       s += id;
       s += ", ";
     }
     s += ")";
     return s;
   }
-  std::vector<std::string> getlist() {
+  const std::vector<Name> &getlist() const {
     return id_list;
   }
   virtual Value* compile() const override { return nullptr;}
 private:
-	std::vector<std::string> id_list;
+	std::vector<Name> id_list;
 };
 
 class Formal: public AST {
 public:
-  Formal(char *i, Id_list *idlist, Type_not_from_llvm *t, std::string var = "ref"){
+  Formal(Id_list *idlist, Type_not_from_llvm *t, std::string var){
     if (var.compare("var") == 0)
       by = "PASS_BY_REFERENCE";
     else
       by = "PASS_BY_VALUE";
     id_list = idlist;
-    if (i) {id_list->append_first(i);}
     type = t;
   }
   Formal(Id_list *idlist, Type_not_from_llvm *t){
@@ -1588,36 +1567,44 @@ public:
   Types get_oftype(){
     return type->get_oftype();
   }
-  std::vector<std::string> getIdList(){
+  const std::vector<Name> &getIdList() const {
     return id_list->getlist();
   }
   std::string getby(){
     return by;
   }
   virtual void semfor() override {
-    for (std::string i : id_list->getlist()) {
-      st.insertForwardDecl(i,type->get_type());
+    for (Name i : id_list->getlist()) {
+      cx->st.insertForwardDecl(i,type->get_type());
     }
   }
   virtual void sem() override {
-    for (std::string i : id_list->getlist()){
-      if(!st.foundForward(i)){
-      	if (i.compare("dummy4207210396") == 0) {}
+    symbols.assign(id_list->getlist().size(), nullptr);
+    size_t k = 0;
+    for (Name i : id_list->getlist()){
+      if(!cx->st.foundForward(i)){
+      	if (i == NAME_dummy) {}
       	else{
           if ((type->get_type() == TYPE_array) and (by == "PASS_BY_VALUE")){
-            std::cerr << "ERROR: Arrays should be passed by reference!\n";
-            exit(1);
+            diag().error() << "ERROR: Arrays should be passed by reference!\n";
+            return;
           }
           if (by == "PASS_BY_REFERENCE"){
-            st.insertPointer(i, type->get_type());
+            cx->st.insertPointer(i, type->get_type());
           }
           else{
-            st.insert(i,type->get_type());  
+            cx->st.insert(i,type->get_type());  
           }
+          symbols[k] = cx->st.symbol(i);
 	      }
       }
+      k++;
     }
   }
+  // the symbol of the k-th parameter (nullptr if sem declared none)
+  Symbol *get_symbol(size_t k) const {
+    return k < symbols.size() ? symbols[k] : nullptr;
+  }
   virtual Value* compile() const override {
   	return nullptr;
   }
@@ -1626,16 +1613,13 @@ private:
   Id_list *id_list;
   Type_not_from_llvm *type;
   std::string by;
+  std::vector<Symbol *> symbols;
 };
 
 class Formal_list: public AST {
 public:
   Formal_list(): formal_list(){ }
-  ~Formal_list() {
-    for (Formal *f : formal_list) delete f;
-  }
   void append(Formal* f) { formal_list.push_back(f); }
-  void append_first(Formal *f) { formal_list.insert(formal_list.begin(), f); }
   virtual void printOn(std::ostream &out) const override {
     out << "Formallist(";
     if (!formal_list.empty()){
@@ -1658,7 +1642,7 @@ public:
 	}
     return s;
   }
-  std::vector<Formal *> getlist() {
+  const std::vector<Formal *> &getlist() const {
     return formal_list;
   }
   virtual void semfor() override{
@@ -1674,77 +1658,74 @@ private:
 
 class Call: public Stmt{
 public:
-  Call(char* i) {
+  Call(Name i) {
     id = i;
     expr_list = nullptr;
+    callee = nullptr;
   }
-  Call(char* i, Expr *e, Exprlist *el = nullptr){
+  Call(Name i, Exprlist *el){
     id = i;
     expr_list = el;
-    if (e) expr_list->append_first(e);
-  }
-  ~Call(){
-    delete id;
-    delete expr_list;
+    callee = nullptr;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Call(";
-    if (id) out << id;
+    out << id;
     if (expr_list) expr_list->printOn(out);
     out << ")";
   }
   virtual std::string getstring() override {
     std::string s = "";
     s += "Call(";
-    if (id) s += std::string(id);
+    s += id.str();
     if (expr_list) s += expr_list->getstring();
     s += ")";
     return s;
   }
   virtual void sem() override {
-    std::string s = id;
+    Name s = id;
     if(expr_list) {
       expr_list->sem();
     }
-    st.lookup(s);
+    callee = cx->st.lookupSymbol(s);
     if (isLibFunc(s)){
-      if (s.compare("writeInteger") == 0){
+      if (s == NAME_writeInteger){
         if (expr_list->getlist().at(0)->get_type() != TYPE_int){
-          std::cerr << "ERROR: writeInteger needs integer argument. A " << expr_list->getlist().at(0)->get_type() << " was given.\n";
-          exit(1);
+          diag().error() << "ERROR: writeInteger needs integer argument. A " << expr_list->getlist().at(0)->get_type() << " was given.\n";
+          return;
         }
-        else if (st.ispointer(expr_list->getlist().at(0)->get_char_var())){
-          std::cerr << "ERROR: writeInteger needs integer argument and not a pointer\n";
-          exit(1);
+        else if (cx->st.ispointer(expr_list->getlist().at(0)->get_char_var())){
+          diag().error() << "ERROR: writeInteger needs integer argument and not a pointer\n";
+          return;
         }
       }
-      if (s.compare("writeBoolean") == 0){
+      if (s == NAME_writeBoolean){
         if (expr_list->getlist().at(0)->get_type() != TYPE_bool){
-          std::cerr << "ERROR: writeBoolean needs boolean argument. A " << expr_list->getlist().at(0)->get_type() << " was given.\n";
-          exit(1);
+          diag().error() << "ERROR: writeBoolean needs boolean argument. A " << expr_list->getlist().at(0)->get_type() << " was given.\n";
+          return;
         }
-        else if (st.ispointer(expr_list->getlist().at(0)->get_char_var())){
-          std::cerr << "ERROR: writeBoolean needs boolean argument and not a pointer\n";
-          exit(1);
+        else if (cx->st.ispointer(expr_list->getlist().at(0)->get_char_var())){
+          diag().error() << "ERROR: writeBoolean needs boolean argument and not a pointer\n";
+          return;
         }
       }
-      if (s.compare("writeChar") == 0){
+      if (s == NAME_writeChar){
         if (expr_list->getlist().at(0)->get_type() != TYPE_char){
-          std::cerr << "ERROR: writeChar needs char argument. A " << expr_list->getlist().at(0)->get_type() << " was given.\n";
-          exit(1);
+          diag().error() << "ERROR: writeChar needs char argument. A " << expr_list->getlist().at(0)->get_type() << " was given.\n";
+          return;
         }
-        else if (st.ispointer(expr_list->getlist().at(0)->get_char_var())){
-          std::cerr << "ERROR: writeChar needs char argument and not a pointer\n";
-          exit(1);
+        else if (cx->st.ispointer(expr_list->getlist().at(0)->get_char_var())){
+          diag().error() << "ERROR: writeChar needs char argument and not a pointer\n";
+          return;
         }
       }
     }
-    if (st.foundProc(s)){
+    if (callee->proc){
       std::vector<Formal *> formal_list;
       int expected = 0;
       int given = 0;
-      if (st.getFormalsProcedureAll(s)){
-        formal_list = st.getFormalsProcedureAll(s)->getlist();
+      if (callee->formals){
+        formal_list = callee->formals->getlist();
         if(expr_list) given = expr_list->getlist().size();
         if (!formal_list.empty()){
         	for (Formal *f : formal_list){
@@ -1753,10 +1734,10 @@ public:
         }
       }
       if (given != expected) {
-        std::cerr << "ERROR: Procedure " << s << " needs " << expected <<" arguments. However " << given << " are given.\n";
-        exit(1);
+        diag().error() << "ERROR: Procedure " << s << " needs " << expected <<" arguments. However " << given << " are given.\n";
+        return;
       }
-      if (st.getFormalsProcedureAll(s)){
+      if (callee->formals){
         if(!formal_list.empty()){ //count how many args we expect the proc to have
         	int j = 0;
           for (Formal *f : formal_list){
@@ -1765,14 +1746,14 @@ public:
             formalsize = f->getIdList().size();
             for (int i = 0; i < formalsize; i++){
               if (!(f->get_type() == expr_list->getlist().at(j)->get_type())){
-                std::cerr << "ERROR: In procedure" << s << " type mismatch regarding arguments ";
+                diag().error() << "ERROR: In procedure" << s << " type mismatch regarding arguments ";
                 std::cerr << f->getIdList().at(j) << " and " << expr_list->getlist().at(j);
                 std::cerr << ". One is of type ";
                 std::cerr << f->get_type();
                 std::cerr << " and the other one is of type ";
                 std::cerr << expr_list->getlist().at(j)->get_type();
                 std::cerr << "\n";
-                exit(1);
+                return;
               }
               j++;
             }
@@ -1780,73 +1761,72 @@ public:
         }
       }
     }
-    else if (st.foundFunc(s)){
-      std::cerr << "ERROR: A function can only be used as a right-value!\n";
-      exit(1);
+    else if (callee->func){
+      diag().error() << "ERROR: A function can only be used as a right-value!\n";
+      return;
     }
   }
   virtual Value* compile() const override { 
-    std::string s = id;
+    Name s = id;
     if (isLibFunc(s)){  //if it's a library proc
-    	std::vector<Expr *> list;
-    	list = expr_list->getlist();
+    	const std::vector<Expr *> &list = expr_list->getlist();
     	Value *n = list.front()->compile();
-    	if ((strcmp(id, "writeInteger")) == 0){
+    	if (id == NAME_writeInteger){
     		if (!n) {std::cerr << "there is no n\n";}
         if (n->getType()->isPointerTy()) {
           std::cerr << "ERROR: writeInteger expects integer not ^integer\n"; 
           exit(1);
         }
-    		Value *n64 = Builder.CreateZExt(n, i64, "ext");
-    		Builder.CreateCall(TheWriteInteger, std::vector<Value *> { n64 });
+    		Value *n64 = cx->Builder.CreateZExt(n, cx->i64, "ext");
+    		cx->Builder.CreateCall(cx->TheWriteInteger, std::vector<Value *> { n64 });
     	}
-    	if ((strcmp(id, "writeBoolean")) == 0){
+    	if (id == NAME_writeBoolean){
         if (n->getType()->isPointerTy()) {
           std::cerr << "ERROR: writeBoolean expects boolean not ^boolean\n"; 
           exit(1);
         }
     		//Value *n8 = Builder.CreateZExt(n, i8, "ext");
-    		Builder.CreateCall(TheWriteBoolean, std::vector<Value *> { n });
+    		cx->Builder.CreateCall(cx->TheWriteBoolean, std::vector<Value *> { n });
     	}
-    	if ((strcmp(id, "writeChar")) == 0){
+    	if (id == NAME_writeChar){
         if (n->getType()->isPointerTy()) {
           std::cerr << "ERROR: writeChar expects char not ^char\n"; 
           exit(1);
         }
-        Value *n8 = Builder.CreateZExtOrTrunc(n, i8, "extrunc");
+        Value *n8 = cx->Builder.CreateZExtOrTrunc(n, cx->i8, "extrunc");
     	  //Value *n8 = c8(n);
-        Builder.CreateCall(TheWriteChar, std::vector<Value *> { n8 });
+        cx->Builder.CreateCall(cx->TheWriteChar, std::vector<Value *> { n8 });
       }
-      if ((strcmp(id, "writeReal")) == 0){
+      if (id == NAME_writeReal){
         if (n->getType()->isPointerTy()) {
           std::cerr << "ERROR: writeReal expects real not ^real\n"; 
           exit(1);
         }
         //Value *n8 = Builder.CreateTrunc(n, X86_FP80TyID, "extrunc");
-        Builder.CreateCall(TheWriteReal, std::vector<Value *> { n });
+        cx->Builder.CreateCall(cx->TheWriteReal, std::vector<Value *> { n });
       }
-      if ((strcmp(id, "writeString")) == 0){
+      if (id == NAME_writeString){
         // Value *n8 = Builder.CreateZExt(n, i8, "ext");
-        Builder.CreateCall(TheWriteString, std::vector<Value *> { n });
+        cx->Builder.CreateCall(cx->TheWriteString, std::vector<Value *> { n });
       }
     }
     else {  //if it's user defined procedure
       
-      std::string fname = id;
-      llvm::Function *F = loggedinfo.getProcInScope(fname);
+      Name fname = id;
+      llvm::Function *F = callee && callee->function ? callee->function : cx->loggedinfo.getProcInScope(fname);
       std::vector<llvm::Value*> argv;
-      std::vector<Expr *> ASTargs;
+      static const std::vector<Expr *> noArgs;
+      const std::vector<Expr *> &ASTargs = expr_list ? expr_list->getlist() : noArgs;
       if (expr_list == nullptr){
         for (auto &Arg: F->args()){
           // function with no parameters, only outer scope ones
           if (ASTargs.empty()) {
-            argv.push_back(deref(loggedinfo.getVarAlloca(Arg.getName().str())));
+            argv.push_back(deref(cx->loggedinfo.getVarAlloca(nameOf(Arg))));
             continue;
           }
         }
       }
       else {
-        ASTargs = expr_list->getlist();
         auto itr = ASTargs.begin();
         auto *ASTarg = *itr;
         // loop through parameters
@@ -1854,7 +1834,7 @@ public:
           llvm::Value *arg;
           // function with no parameters, only outer scope ones
           if (ASTargs.empty()) {
-            argv.push_back(deref(loggedinfo.getVarAlloca(Arg.getName().str())));
+            argv.push_back(deref(cx->loggedinfo.getVarAlloca(nameOf(Arg))));
             continue;
           }
 
@@ -1862,7 +1842,7 @@ public:
 
           //check if done with real parameters
           if (ASTarg == nullptr) {
-            argv.push_back(deref(loggedinfo.getVarAlloca(Arg.getName().str())));
+            argv.push_back(deref(cx->loggedinfo.getVarAlloca(nameOf(Arg))));
             continue;
           }
           
@@ -1872,8 +1852,8 @@ public:
           }
           else {
             //variable
-            std::string var = ASTarg->get_char_var();
-            arg = calcAddr(var, "ID", nullptr);
+            Name var = ASTarg->get_char_var();
+            arg = calcAddr(var, "ID", nullptr, ASTarg->get_symbol());
           }
 
           argv.push_back(arg);
@@ -1882,90 +1862,58 @@ public:
         }
       }
       
-      return Builder.CreateCall(F,argv);
+      return cx->Builder.CreateCall(F,argv);
     }
   	return nullptr;
   }
 private:
-  char* id;
+  Name id;
   Exprlist *expr_list;
+  Symbol *callee;
 };
 
 class ExprCall: public Rvalue{
 public:
-  ExprCall(char* i) {
+  ExprCall(Name i) {
     id = i;
     expr_list = nullptr;
+    callee = nullptr;
   }
-  ExprCall(char* i, Expr *e, Exprlist *el = nullptr){
+  ExprCall(Name i, Exprlist *el){
     id = i;
     expr_list = el;
-    if (e) expr_list->append_first(e);
-  }
-  ~ExprCall(){
-    delete id;
-    delete expr_list;
+    callee = nullptr;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "ExprCall(";
-    if (id) out <<"id: " << id << ",";
+    out <<"id: " << id << ",";
     if (expr_list) expr_list->printOn(out);
     out << ")";
   }
   virtual std::string getstring() override {
     std::string s = "";
     s += "ExprCall(";
-    if (id) s += std::string(id) + ",";
+    s += id.str() + ",";
     if (expr_list) s += expr_list->getstring();
     s += ")";
     return s;
   }
-  virtual Types get_type() override {
-  	std::string s = id;
-  	if (isLibFunc(s)){
-  		if ((strcmp(id, "readInteger")) == 0) {return TYPE_int; }
-  		if ((strcmp(id, "readBoolean")) == 0) {return TYPE_bool; }
-  		if ((strcmp(id, "readChar")) == 0) {return TYPE_char; }
-  		if ((strcmp(id, "readReal")) == 0) {return TYPE_real; }
-  		if ((strcmp(id, "readString")) == 0) {return TYPE_string; }
-  		if ((strcmp(id, "abs")) == 0) { return TYPE_int;}
-  		if ((strcmp(id, "fabs")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "sqrt")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "sin")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "cos")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "tan")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "arctan")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "exp")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "ln")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "pi")) == 0) { return TYPE_real;}
-  		if ((strcmp(id, "trunc")) == 0) { return TYPE_int;}
-  		if ((strcmp(id, "round")) == 0) { return TYPE_int;}
-  		if ((strcmp(id, "chr")) == 0) { return TYPE_char;}
-  		if ((strcmp(id, "ord")) == 0) {return TYPE_int; }
-  	}
-  	else if (st.foundProc(s)){
-  		std::cerr << "ERROR: Procedures can only be of type void\n";
-  		exit(1);
-  	}
-  	else if (st.foundFunc(s)){
-  		return st.getFunctionType(s);
-  	}
-  	return TYPE_error;	// this should be unreachable
-  }
   virtual void sem() override {
-    std::string s = id;
+    Name s = id;
     if(expr_list) expr_list->sem();
-    st.lookup(s);
-    if (st.foundProc(s)){
-      std::cerr << "ERROR: A procedure returns void, so it cannot be used as a right-value\n";
-      exit(1);
-    }
-    else if (st.foundFunc(s)){
+    callee = cx->st.lookupSymbol(s);
+    // the library's functions are declared with their types too
+    if (callee->func) type = callee->entry.type;
+    if (callee->proc){
+      diag().error() << "ERROR: A procedure returns void, so it cannot be used as a right-value\n";
+      return;
+    }
+    else if (callee->func){
       std::vector<Formal *> formal_list;
       int expected = 0;
       int given = 0;
-      if (st.getFormalsFuncAll(s)){
-        formal_list = st.getFormalsFuncAll(s)->getlist();
+      if (callee->formals){
+        formal_list = callee->formals->getlist();
         if(!formal_list.empty()){ //count how many args we expect the proc to have
           for (Formal *f : formal_list){
             expected += int(f->getIdList().size());
@@ -1974,14 +1922,14 @@ public:
             int j = 0;
             for (int i = 0; i < formalsize; i++){
               if (!(f->get_type() == expr_list->getlist().at(j)->get_type())){
-                std::cerr << "ERROR: In Function" << s << " type mismatch regarding arguments ";
+                diag().error() << "ERROR: In Function" << s << " type mismatch regarding arguments ";
                 std::cerr << f->getIdList().at(j) << " and " << expr_list->getlist().at(i);
                 std::cerr << ". One is of type ";
                 std::cerr << f->get_type();
                 std::cerr << " and the other one is of type ";
                 std::cerr << expr_list->getlist().at(j)->get_type();
                 std::cerr << "\n";
-                exit(1);
+                return;
                 j++;
               }
             }
@@ -1990,67 +1938,66 @@ public:
       }
       if(expr_list) given = expr_list->getlist().size();
       if (given != expected) {
-        std::cerr << "ERROR: Function " << s << " needs " << expected <<" arguments. However " << given << " are given.\n";
-        exit(1);
+        diag().error() << "ERROR: Function " << s << " needs " << expected <<" arguments. However " << given << " are given.\n";
+        return;
       }
     }
   }
   virtual Value* compile() const override { 
-    std::string s = id;
+    Name s = id;
   	if (isLibFunc(s)){
-      std::vector<Expr *> list;
-        if ((strcmp(id, "readInteger")) == 0){
-          return Builder.CreateCall(TheReadInteger, std::vector<Value *> { });
+        if (id == NAME_readInteger){
+          return cx->Builder.CreateCall(cx->TheReadInteger, std::vector<Value *> { });
         }
-        if ((strcmp(id, "readBoolean")) == 0){
+        if (id == NAME_readBoolean){
           
-          return Builder.CreateCall(TheReadBoolean, std::vector<Value *> {  });
+          return cx->Builder.CreateCall(cx->TheReadBoolean, std::vector<Value *> {  });
           
         }
-        if ((strcmp(id, "readChar")) == 0){
-          return Builder.CreateCall(TheReadChar, std::vector<Value *> {  });
+        if (id == NAME_readChar){
+          return cx->Builder.CreateCall(cx->TheReadChar, std::vector<Value *> {  });
         }
-        if ((strcmp(id, "readString")) == 0){
+        if (id == NAME_readString){
          
           if (expr_list){
-          	list = expr_list->getlist();
+          	const std::vector<Expr *> &list = expr_list->getlist();
           	Value *n = list.front()->compile();
           	Value *arr = (list.at(1))->compile();
-          	return Builder.CreateCall(TheReadString, std::vector<Value *> { n, arr });
+          	return cx->Builder.CreateCall(cx->TheReadString, std::vector<Value *> { n, arr });
           }
           else{
           	/*some error message */
           }
           
         }
-        if ((strcmp(id, "abs")) == 0){
+        if (id == NAME_abs){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
-            Value *n64 = Builder.CreateZExt(n, i32, "ext");
-            return Builder.CreateCall(TheAbs, std::vector<Value *> { n64 });
+            Value *n64 = cx->Builder.CreateZExt(n, cx->i32, "ext");
+            return cx->Builder.CreateCall(cx->TheAbs, std::vector<Value *> { n64 });
           }
           else {
             /*some error message*/
           }
         }
-        if ((strcmp(id, "fabs")) == 0){
+        if (id == NAME_fabs){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             //Value *n64 = Builder.CreateZExt(n, i32, "ext");
-            return Builder.CreateCall(TheFabs, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheFabs, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
           }
         }
-        if ((strcmp(id, "sqrt")) == 0){
+        if (id == NAME_sqrt){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             
-            return Builder.CreateCall(TheSqrt, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheSqrt, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2058,12 +2005,12 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "sin")) == 0){
+        if (id == NAME_sin){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             
-            return Builder.CreateCall(TheSin, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheSin, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2071,12 +2018,12 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "cos")) == 0){
+        if (id == NAME_cos){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             
-            return Builder.CreateCall(TheCos, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheCos, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2084,12 +2031,12 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "tan")) == 0){
+        if (id == NAME_tan){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             
-            return Builder.CreateCall(TheTan, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheTan, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2097,12 +2044,12 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "arctan")) == 0){
+        if (id == NAME_arctan){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             
-            return Builder.CreateCall(TheArctan, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheArctan, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2110,12 +2057,12 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "exp")) == 0){
+        if (id == NAME_exp){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
             
-            return Builder.CreateCall(TheExp, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheExp, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2123,11 +2070,11 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "ln")) == 0){
+        if (id == NAME_ln){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
-            return Builder.CreateCall(TheLn, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheLn, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2135,14 +2082,14 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "pi")) == 0){
-          return Builder.CreateCall(ThePi, std::vector<Value *> { });
+        if (id == NAME_pi){
+          return cx->Builder.CreateCall(cx->ThePi, std::vector<Value *> { });
         }
-        if ((strcmp(id, "trunc")) == 0){
+        if (id == NAME_trunc){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
-            return Builder.CreateCall(TheTrunc, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheTrunc, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2150,11 +2097,11 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "round")) == 0){
+        if (id == NAME_round){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
-            return Builder.CreateCall(TheRound, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheRound, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2162,11 +2109,11 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "ord")) == 0){
+        if (id == NAME_ord){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
-            return Builder.CreateCall(TheOrd, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheOrd, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2174,11 +2121,11 @@ public:
             exit(1);
           }
         }
-        if ((strcmp(id, "chr")) == 0){
+        if (id == NAME_chr){
           if (expr_list){
-            list = expr_list->getlist();
+            const std::vector<Expr *> &list = expr_list->getlist();
             Value *n = list.front()->compile();
-            return Builder.CreateCall(TheChr, std::vector<Value *> { n });
+            return cx->Builder.CreateCall(cx->TheChr, std::vector<Value *> { n });
           }
           else {
             /*some error message*/
@@ -2189,14 +2136,14 @@ public:
     }
     else{ //user defined function
       
-      std::string fname = id;
+      Name fname = id;
       
-      llvm::Function *F = loggedinfo.getFunctionInScope(fname);
+      llvm::Function *F = callee && callee->function ? callee->function : cx->loggedinfo.getFunctionInScope(fname);
       std::vector<llvm::Value*> argv;
-      std::vector<Expr *> ASTargs;
+      static const std::vector<Expr *> noArgs;
+      const std::vector<Expr *> &ASTargs = expr_list ? expr_list->getlist() : noArgs;
 
       if (expr_list){
-        ASTargs = expr_list->getlist();
         auto itr = ASTargs.begin();
         auto *ASTarg = *itr;
         // loop through parameters
@@ -2205,7 +2152,7 @@ public:
           llvm::Value *arg;
           // function with no parameters, only outer scope ones
           if (ASTargs.empty()) {
-            argv.push_back(deref(loggedinfo.getVarAlloca(Arg.getName().str())));
+            argv.push_back(deref(cx->loggedinfo.getVarAlloca(nameOf(Arg))));
             continue;
           }
 
@@ -2213,7 +2160,7 @@ public:
 
           // check if done with real parameters
           if (ASTarg == nullptr) {
-            argv.push_back(deref(loggedinfo.getVarAlloca(Arg.getName().str())));
+            argv.push_back(deref(cx->loggedinfo.getVarAlloca(nameOf(Arg))));
             continue;
           }
           
@@ -2223,8 +2170,8 @@ public:
           }
           else {
             //variable
-            std::string var = ASTarg->get_char_var();
-            arg = calcAddr(var, "ID", nullptr);
+            Name var = ASTarg->get_char_var();
+            arg = calcAddr(var, "ID", nullptr, ASTarg->get_symbol());
           }
 
           argv.push_back(arg);
@@ -2236,7 +2183,7 @@ public:
         for (auto &Arg: F->args()){
           // function with no parameters, only outer scope ones
           if (ASTargs.empty()) {
-            argv.push_back(deref(loggedinfo.getVarAlloca(Arg.getName().str())));
+            argv.push_back(deref(cx->loggedinfo.getVarAlloca(nameOf(Arg))));
             continue;
           }
         }
@@ -2244,13 +2191,14 @@ public:
       
       
       
-      return Builder.CreateCall(F,argv);
+      return cx->Builder.CreateCall(F,argv);
     }
     return nullptr;
   }
 private:
-  char* id;
+  Name id;
   Exprlist *expr_list;
+  Symbol *callee;
 };
 
 class New: public Stmt {
@@ -2287,70 +2235,61 @@ public:
       // new [ expr ] lvalue
       lvalue->sem();
       brackets->sem();
-      if (lvalue->get_type() == TYPE_result){
-        lvalue->set_type(st.lookup("result")->type);
-      }
-      if (brackets->get_type() == TYPE_result){
-        brackets->set_type(st.lookup("result")->type);
-      }
       if (lvalue->get_type() != TYPE_pointer){
-        std::cerr << "\nError: In expression: ";
+        diag().error() << "\nError: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nleft value of the expression must be of type pointer but it's of type: " << lvalue->get_type() << "\n";
-        exit(1);
+        return;
       }
       else{
         if (lvalue->get_type() == TYPE_pointer){
           if (lvalue->get_pointer()->get_oftype() != TYPE_array){
-            std::cerr << "\nERORR: In expression: ";
+            diag().error() << "\nERORR: In expression: ";
             printOn(std::cerr);
             std::cerr << "\nleft value of the expression must be of type pointer to array but it's a pointer to ";
             std::cerr << lvalue->get_pointer()->get_oftype();
             std::cerr << "\n";
-            exit(1);
+            return;
           }
         }
         
       }
       if (brackets->get_type() != TYPE_int){
-        std::cerr << "\nERROR: In expression: ";
+        diag().error() << "\nERROR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nthe expression inside the brackets must be of type integer but it's of type: ";
         std::cerr << brackets->get_type();
         std::cerr << "\n";
-        exit(1);
+        return;
       }
-      st.makeNew(lvalue->getstring());
+      cx->st.makeNew(lvalue->getstring());
     }
     else {
       //"new" lvalue
       lvalue->sem();
-      if (lvalue->get_type() == TYPE_result){
-        lvalue->set_type(st.lookup("result")->type);
-      }
       if (lvalue->get_type() != TYPE_pointer){
-        std::cerr << "\nERROR: In expression: ";
+        diag().error() << "\nERROR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nleft value of the expression must be of type pointer but it's of type: " << lvalue->get_type() << "\n";
-        exit(1);
+        return;
       }
-      st.makeNew(lvalue->getstring());
+      cx->st.makeNew(lvalue->getstring());
     }
   }
   virtual Value* compile() const override { 
   	if (!(brackets)){  // if allocate pointer
-      std::string var = lvalue->get_char_var();
-      auto *t = loggedinfo.getPoinType(var);
+      Name var = lvalue->get_char_var();
+      auto *t = cx->loggedinfo.getPoinType(var);
       auto *ptype = PointerType::get(t,0);
-      auto *valloca = Builder.CreateAlloca(ptype, 0, var);
-      loggedinfo.changeAlloca(var, ptype, valloca);
+      auto *valloca = cx->Builder.CreateAlloca(ptype, 0, var.str());
+      cx->loggedinfo.changeAlloca(var, ptype, valloca, lvalue->get_symbol());
     }
     else{ // if allocate array
-      std::string var = lvalue->get_char_var();
-      auto *t = loggedinfo.getArrType(var);
+      Name var = lvalue->get_char_var();
+      auto *t = cx->loggedinfo.getArrType(var);
       auto *atype = ArrayType::get(t,brackets->eval());
-      auto *valloca = Builder.CreateAlloca(atype, 0, var);
-      loggedinfo.changeAlloca(var, atype,valloca);
+      auto *valloca = cx->Builder.CreateAlloca(atype, 0, var.str());
+      cx->loggedinfo.changeAlloca(var, atype,valloca, lvalue->get_symbol());
     }
     return nullptr;
   }
@@ -2362,7 +2301,7 @@ private:
 
 class Goto: public Stmt {
 public:
-  Goto(char* i){
+  Goto(Name i){
     id = i;
   }
   virtual void printOn(std::ostream &out) const override {
@@ -2378,44 +2317,43 @@ public:
     return s;
   }
   virtual void sem() override {
-    std::string s_id;
-    s_id = id;
-    if (!st.isLabel(s_id)){
-      std::cerr << "\nERORR: In expression: ";
+    Name s_id = id;
+    if (!cx->st.isLabel(s_id)){
+      diag().error() << "\nERORR: In expression: ";
       printOn(std::cerr);
       std::cerr << "\n" << s_id << "is not a label!\n";
-      exit(1);
+      return;
     }
     else {
-     if (!st.LabelHasStmt(s_id)){
-       std::cerr << "\nERORR: In expression: ";
+     if (!cx->st.LabelHasStmt(s_id)){
+       diag().error() << "\nERORR: In expression: ";
        printOn(std::cerr);
        std::cerr << "\nLabel " << s_id << " does not correspond to a statement!\n";
-       exit(1);
+       return;
      }
     }
   }
   virtual Value* compile() const override {
-  	std::string label = id;
-    auto *label_block = loggedinfo.getLabelBlock(label);
-    auto *after_block = loggedinfo.getLabelCont(label);
-    Function *function = Builder.GetInsertBlock()->getParent();
-    auto *b = BasicBlock::Create(TheContext, "goto", function);
-    auto *e = BasicBlock::Create(TheContext, "gotoafter", function);
-    Builder.CreateBr(label_block);
-    Builder.SetInsertPoint(b);
-    Builder.CreateBr(after_block);
-    Builder.SetInsertPoint(e);
+  	Name label = id;
+    auto *label_block = cx->loggedinfo.getLabelBlock(label);
+    auto *after_block = cx->loggedinfo.getLabelCont(label);
+    Function *function = cx->Builder.GetInsertBlock()->getParent();
+    auto *b = BasicBlock::Create(cx->TheContext, "goto", function);
+    auto *e = BasicBlock::Create(cx->TheContext, "gotoafter", function);
+    cx->Builder.CreateBr(label_block);
+    cx->Builder.SetInsertPoint(b);
+    cx->Builder.CreateBr(after_block);
+    cx->Builder.SetInsertPoint(e);
     return nullptr;
   }
 private:
-  char* id;
+  Name id;
 };
 
 class Intconst: public Rvalue {
 public:
   Intconst(int i): cons(i){
-    type = new Int();
+    type = TYPE_int;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Intconst(";
@@ -2429,16 +2367,12 @@ public:
     s += ")";
     return s;
   }
-  virtual Types get_type() override{
-    return type->get_type();
-  }
   virtual int eval() const override {return cons; }
   virtual int get() {
     return cons;
   }
   virtual Value* compile() const override { return c32(cons);}
 private:
-  Type_not_from_llvm *type;
   int cons;
 };
 
@@ -2451,11 +2385,11 @@ public:
     else {
       cons = 0;
     }
-    type = new Bool();
+    type = TYPE_bool;
   }
   Boolconst(bool b){
     cons = b;
-    type = new Bool();
+    type = TYPE_bool;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Boolconst(";
@@ -2469,20 +2403,16 @@ public:
     s += ")";
     return s;
   }
-  virtual Types get_type() override{
-    return type->get_type();
-  }
   virtual int eval() const override { return cons; }
   virtual Value* compile() const override { return c1(cons);}
 private:
-  Type_not_from_llvm *type;
   bool cons;
 };
 
 class Realconst: public Rvalue {
 public:
   Realconst(long double r): cons(r) {
-    type = new Real();
+    type = TYPE_real;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Realconst(";
@@ -2496,20 +2426,16 @@ public:
     s += ")";
     return s;
   }
-  virtual Types get_type() override{
-    return type->get_type();
-  }
   virtual int eval() const override { return cons; }
-  virtual Value* compile() const override { return Builder.CreateFPExt(fp32(cons), X86_FP80TyID, "ext");}
+  virtual Value* compile() const override { return cx->Builder.CreateFPExt(fp32(cons), cx->X86_FP80TyID, "ext");}
 private:
-  Type_not_from_llvm *type;
   float cons;
 };
 
 class Charconst: public Rvalue {
 public:
-  Charconst(char *c): cons(c) {
-    type = new Char();
+  Charconst(const char *c): cons(c) {
+    type = TYPE_char;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Charconst(";
@@ -2523,23 +2449,21 @@ public:
     s += ")";
     return s;
   }
-  virtual Types get_type() override{
-    return type->get_type();
-  }
   virtual int eval() const override { return 0; }
   virtual Value* compile() const override {
     char ch = cons[1];
     return c8(ch);
   }
 private:
-  Type_not_from_llvm *type;
-  char *cons;
+  const char *cons;
 };
 
 class Stringconst: public Lvalue {
 public:
   Stringconst(char *c): cons(c) {
-    arr = new Array(TYPE_char, strlen(c) - 1);
+    arr = Array::get(TYPE_char, strlen(c) - 1);
+    type = TYPE_array;
+    set_array(arr);
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Stringconst(" << cons << ")";
@@ -2551,15 +2475,12 @@ public:
     s += ")";
     return s;
   }
-  virtual Types get_type() override{
-    return TYPE_array;
-  }
   virtual bool isresult() {
     return false;
   }
   virtual int eval() const override { return 0; }
   virtual Value* compile() const override { 
-  	return Builder.CreateGlobalStringPtr(cons);
+  	return cx->Builder.CreateGlobalStringPtr(cons);
   }
 private:
   Array *arr;
@@ -2580,23 +2501,19 @@ public:
     s += "Nil()";
     return s;
   }
-  virtual Types get_type() override{
-    return type;
-  }
   virtual int eval() const override { return 0; } //huh?
   virtual Value* compile() const override { 
-  	return ConstantPointerNull::get(PointerType::get(i32,0));
+  	return ConstantPointerNull::get(PointerType::get(cx->i32,0));
   }
 private:
-  Types type;
   char *cons;
 };
 
 class Dispose: public Stmt {
 public:
-  Dispose(char* b, Expr *lval){
+  Dispose(Expr *lval, bool b){
     lvalue = lval;
-    if (*b == '['){ brackets = true; }
+    brackets = b;
   }
   Dispose(Expr *lval){
     lvalue = lval;
@@ -2617,56 +2534,50 @@ public:
   virtual void sem() override {
     if (lvalue && !brackets) { //dispose l-value
       lvalue->sem();
-      if (lvalue->get_type() == TYPE_result){
-        lvalue->set_type(st.lookup("result")->type);
-      }
       if (lvalue->get_type() != TYPE_pointer){
-        std::cerr << "\nERROR: In expression: ";
+        diag().error() << "\nERROR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nleft value of the expression must be of type pointer but it's of type: " << lvalue->get_type() << "\n";
-        exit(1);
+        return;
       }
-      if (!st.isNew(lvalue->getstring())){
-        std::cerr << "\nERROR: In expression: ";
+      if (!cx->st.isNew(lvalue->getstring())){
+        diag().error() << "\nERROR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nleft value of the expression must be created from a new l-value\n";
-        exit(1);
+        return;
       }
       lvalue = nullptr;
     }
     else { //dispose [] l-value
       lvalue->sem();
-      if(lvalue->get_type() == TYPE_result){
-        lvalue->set_type(st.lookup("result")->type);
-      }
       if (lvalue->get_type() != TYPE_pointer) {
-        std::cerr << "\nERROR: In expression: ";
+        diag().error() << "\nERROR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nleft value of the expression must be of type pointer but it's of type: " << lvalue->get_type() << "\n";
-        exit(1);
+        return;
       }
-      if (!st.isNew(lvalue->getstring())){
-        std::cerr << "\nERROR: In expression: ";
+      if (!cx->st.isNew(lvalue->getstring())){
+        diag().error() << "\nERROR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nleft value of the expression must be created from a new l-value\n";
-        exit(1);
+        return;
       }
       if (lvalue->get_type() == TYPE_pointer){
         if (lvalue->get_pointer()->get_oftype() != TYPE_array){
-          std::cerr << "\nERROR: In expression: ";
+          diag().error() << "\nERROR: In expression: ";
           printOn(std::cerr);
           std::cerr << "\nleft value of the expression must be of type pointer to array but it's pointer to ";
           std::cerr << lvalue->get_pointer()->get_oftype();
           std::cerr << "\n";
-          exit(1);
+          return;
         }
       }
       lvalue = nullptr;
     }
   }
   virtual Value* compile() const override { 
-    std::string var = lvalue->get_char_var();
-    loggedinfo.disposePointer(var);
+    Name var = lvalue->get_char_var();
+    cx->loggedinfo.disposePointer(var, lvalue->get_symbol());
     return nullptr;
   }
 private:
@@ -2678,7 +2589,6 @@ class If: public Stmt {
 public:
   If(Expr *c, Stmt *s1, Stmt *s2 = nullptr):
     cond(c), stmt1(s1), stmt2(s2) {}
-  ~If() { delete cond; delete stmt1; delete stmt2; }
   virtual void printOn(std::ostream &out) const override {
     out << "If(" << *cond << ", " << *stmt1;
     if (stmt2 != nullptr) out << ", " << *stmt2;
@@ -2697,18 +2607,15 @@ public:
   }
   virtual void sem() override {
     cond->sem();
-    if(cond->get_type() == TYPE_result){
-      cond->set_type(st.lookup("result")->type);
-    }
     if (cond->get_type() == TYPE_bool){
       stmt1->sem();
       if (stmt2 != nullptr) stmt2->sem();
     }
     else {
-      std::cerr << "\nERORR: In expression: ";
+      diag().error() << "\nERORR: In expression: ";
       printOn(std::cerr);
       std::cerr << "\nCondition is not of type bool!\n";
-      exit(1);
+      return;
     }
   }
   virtual Value* compile() const override {
@@ -2717,22 +2624,22 @@ public:
     if (!condv)
     	return nullptr;
 
-    Function *TheFunction = Builder.GetInsertBlock()->getParent();
+    Function *TheFunction = cx->Builder.GetInsertBlock()->getParent();
     BasicBlock *ThenBB =
-      BasicBlock::Create(TheContext, "then", TheFunction);
+      BasicBlock::Create(cx->TheContext, "then", TheFunction);
     BasicBlock *ElseBB =
-      BasicBlock::Create(TheContext, "else", TheFunction);
+      BasicBlock::Create(cx->TheContext, "else", TheFunction);
     BasicBlock *AfterBB =
-      BasicBlock::Create(TheContext, "endif", TheFunction);
-    Builder.CreateCondBr(condv, ThenBB, ElseBB);
-    Builder.SetInsertPoint(ThenBB);
+      BasicBlock::Create(cx->TheContext, "endif", TheFunction);
+    cx->Builder.CreateCondBr(condv, ThenBB, ElseBB);
+    cx->Builder.SetInsertPoint(ThenBB);
     stmt1->compile();
-    Builder.CreateBr(AfterBB);
-    Builder.SetInsertPoint(ElseBB);
+    cx->Builder.CreateBr(AfterBB);
+    cx->Builder.SetInsertPoint(ElseBB);
     if (stmt2 != nullptr)
       stmt2->compile();
-    Builder.CreateBr(AfterBB);
-    Builder.SetInsertPoint(AfterBB);
+    cx->Builder.CreateBr(AfterBB);
+    cx->Builder.SetInsertPoint(AfterBB);
     return nullptr;
   }
 private:
@@ -2747,10 +2654,6 @@ public:
     stmt = st;
     cond = e;
   }
-  ~While() {
-    delete cond;
-    delete stmt;
-  }
   virtual void printOn(std::ostream &out) const override {
       out << "While(" << *cond << ", " << *stmt;
       out << ")";
@@ -2765,36 +2668,33 @@ public:
   }
   virtual void sem() override {
       cond->sem();
-      if (cond->get_type() == TYPE_result){
-        cond->set_type(st.lookup("result")->type);
-      }
       if (cond->get_type() == TYPE_bool){
         stmt->sem();
       }
       else {
-        std::cerr << "\nERORR: In expression: ";
+        diag().error() << "\nERORR: In expression: ";
         printOn(std::cerr);
         std::cerr << "\nCondition is not of type bool!\n";
-        exit(1);
+        return;
       }
   }
   virtual Value* compile() const override {
-      BasicBlock *PrevBB = Builder.GetInsertBlock();
+      BasicBlock *PrevBB = cx->Builder.GetInsertBlock();
       Function *TheFunction = PrevBB->getParent();
       BasicBlock *LoopBB =
-        BasicBlock::Create(TheContext, "loop", TheFunction);
+        BasicBlock::Create(cx->TheContext, "loop", TheFunction);
       BasicBlock *BodyBB =
-        BasicBlock::Create(TheContext, "body", TheFunction);
+        BasicBlock::Create(cx->TheContext, "body", TheFunction);
       BasicBlock *AfterBB =
-        BasicBlock::Create(TheContext, "endwhile", TheFunction);
-      Builder.CreateBr(LoopBB);
-      Builder.SetInsertPoint(LoopBB);
-      Builder.CreateCondBr(cond->compile(), BodyBB, AfterBB);
-      Builder.SetInsertPoint(BodyBB);
+        BasicBlock::Create(cx->TheContext, "endwhile", TheFunction);
+      cx->Builder.CreateBr(LoopBB);
+      cx->Builder.SetInsertPoint(LoopBB);
+      cx->Builder.CreateCondBr(cond->compile(), BodyBB, AfterBB);
+      cx->Builder.SetInsertPoint(BodyBB);
 
       stmt->compile();
-      Builder.CreateBr(LoopBB);
-      Builder.SetInsertPoint(AfterBB);
+      cx->Builder.CreateBr(LoopBB);
+      cx->Builder.SetInsertPoint(AfterBB);
 
       return nullptr;
   }
@@ -2805,16 +2705,8 @@ private:
 
 class Block: public Stmt {
 public:
-  Block(Stmt *st, Stmtlist *s_list){
+  Block(Stmtlist *s_list){
     stmtlist = s_list;
-    if (st) {
-    	stmt = st;
-    	stmtlist->append_first(stmt);
-    }
-  }
-  ~Block() {
-    delete stmt;
-    delete stmtlist;
   }
   virtual void printOn(std::ostream &out) const override {
       out << "Block(";
@@ -2828,14 +2720,14 @@ public:
       return s;
   }
   virtual void sem() override {
-    std::string parent = st.getParent();
-    if(st.getFormalsFuncAll(parent) and (!st.formalsFuncDone(parent))){
-      st.getFormalsFuncAll(parent)->sem();
-      st.setformalsFuncDone(parent);
+    Name parent = cx->st.getParent();
+    if(cx->st.getFormalsFuncAll(parent) and (!cx->st.formalsFuncDone(parent))){
+      cx->st.getFormalsFuncAll(parent)->sem();
+      cx->st.setformalsFuncDone(parent);
     }
-    else if(st.getFormalsProcedureAll(parent) and (!st.formalsProcDone(parent))){
-      st.getFormalsProcedureAll(parent)->sem();
-      st.setformalsProcDone(parent);
+    else if(cx->st.getFormalsProcedureAll(parent) and (!cx->st.formalsProcDone(parent))){
+      cx->st.getFormalsProcedureAll(parent)->sem();
+      cx->st.setformalsProcDone(parent);
     }
     stmtlist->sem();
   }
@@ -2844,19 +2736,14 @@ public:
       return nullptr;
    }
 private:
-  Stmt *stmt;
   Stmtlist *stmtlist;
   int size;
 };
 
 class Label: public AST {
 public:
-  Label(std::string i, Id_list *idlist){
+  Label(Id_list *idlist){
     id_list = idlist;
-    if (!i.empty()) idlist->append_first(i);
-  }
-  ~Label(){
-    delete id_list;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "Label(";
@@ -2871,10 +2758,8 @@ public:
     return s;
   }
   virtual void sem() override {
-    std::vector<std::string> v;
-    v = id_list->getlist();
-    for (std::string s : v){
-      st.insertLabel(s, TYPE_label);
+    for (Name s : id_list->getlist()){
+      cx->st.insertLabel(s, TYPE_label);
     }
   }
   virtual Value* compile() const override { 
@@ -2887,22 +2772,20 @@ private:
 
 class LabelStmt: public Stmt{
 public:
-  LabelStmt(char* i, Stmt *s){
+  LabelStmt(Name i, Stmt *s){
     id = i;
     stmt = s;
   }
   virtual void printOn(std::ostream &out) const override {
     out << "LabelStmt(";
-    if(id) out << id << " ";
+    out << id << " ";
     if(stmt) stmt->printOn(out);
     out << ")";
   }
   virtual std::string getstring() override {
     std::string s ="";
     s += "LabelStmt(";
-    std::string var;
-    var = id;
-    if(id) s+= var + " ";
+    s+= id.str() + " ";
     if(stmt) s+= stmt->getstring();
     s+= ")";
     return s;
@@ -2911,31 +2794,30 @@ public:
     stmt->sem();
   }
   virtual Value* compile() const override { 
-    std::string name = id;
-    Function *TheFunction = Builder.GetInsertBlock()->getParent();
+    Name name = id;
+    Function *TheFunction = cx->Builder.GetInsertBlock()->getParent();
     BasicBlock *BB =
-      BasicBlock::Create(TheContext, name, TheFunction);
+      BasicBlock::Create(cx->TheContext, name.str(), TheFunction);
     BasicBlock *AfterBB =
-      BasicBlock::Create(TheContext, "after", TheFunction);
-    Builder.CreateBr(BB);
-    Builder.SetInsertPoint(BB);
+      BasicBlock::Create(cx->TheContext, "after", TheFunction);
+    cx->Builder.CreateBr(BB);
+    cx->Builder.SetInsertPoint(BB);
     stmt->compile();
-    Builder.CreateBr(AfterBB);
-    Builder.SetInsertPoint(AfterBB);
-    loggedinfo.addLabel(name,BB,AfterBB);
+    cx->Builder.CreateBr(AfterBB);
+    cx->Builder.SetInsertPoint(AfterBB);
+    cx->loggedinfo.addLabel(name,BB,AfterBB);
     return nullptr;
   	
   }
 private:
-  char* id;
+  Name id;
   Stmt *stmt;
 };
 
 class Decl: public AST {
 public:
-  Decl(std::string i, Id_list *idlist, Type_not_from_llvm *t){
+  Decl(Id_list *idlist, Type_not_from_llvm *t){
     id_list = idlist;
-    if (!i.empty()) id_list->append_first(i); 
     type = t;
   }
   virtual void printOn(std::ostream &out) const override {
@@ -2952,28 +2834,35 @@ public:
     return s;
   }
   virtual void sem() {
-    for (std::string s : id_list->getlist()) {
-      st.insert(s, type->get_type());
+    for (Name s : id_list->getlist()) {
+      cx->st.insert(s, type->get_type());
       if (type->get_type() == TYPE_array){
-      	st.insert_array_type(s, type->get_oftype());
+      	cx->st.insert_array_type(s, type->get_oftype());
       }
+      symbols.push_back(cx->st.symbol(s));
     }
   }
+  // the symbol of the k-th variable (nullptr before sem)
+  Symbol *get_symbol(size_t k) const {
+    return k < symbols.size() ? symbols[k] : nullptr;
+  }
   virtual Value* compile() const override {   
 
     if (type->get_type() == TYPE_array){
       
       if (type->get_size() == -1){  //array is not allocated yet. will be with a "new" statement
-        for (std::string var : id_list->getlist()){
+        size_t k = 0;
+        for (Name var : id_list->getlist()){
           auto *t = type_to_llvm(type->get_oftype(), "PASS_BY_VALUE", true);
-          loggedinfo.addVariable(var, nullptr, nullptr);
-          loggedinfo.arrayType(var, t);
+          cx->loggedinfo.addVariable(var, nullptr, nullptr, get_symbol(k++));
+          cx->loggedinfo.arrayType(var, t);
         }
         return nullptr;
       }
       else{ // array size was declared, so allocate the array
         
-        for (std::string var : id_list->getlist()){
+        size_t k = 0;
+        for (Name var : id_list->getlist()){
           
           int num = type->get_size();
 
@@ -2981,11 +2870,11 @@ public:
           
           auto *vtype = llvm::ArrayType::get(t, num);
           
-          auto *valloca = Builder.CreateAlloca(vtype, nullptr, var); 
+          auto *valloca = cx->Builder.CreateAlloca(vtype, nullptr, var.str()); 
           
-          loggedinfo.addVariable(var, vtype, valloca);
+          cx->loggedinfo.addVariable(var, vtype, valloca, get_symbol(k++));
           
-          loggedinfo.arrayType(var, vtype);
+          cx->loggedinfo.arrayType(var, vtype);
           // loggedinfo.arrayType(var, t);
           
           }
@@ -2995,21 +2884,23 @@ public:
     }
     if (type->get_type() == TYPE_pointer) { // pointer will be allocated with a "new" statement
 
-      for (std::string var : id_list->getlist()){
+      size_t k = 0;
+      for (Name var : id_list->getlist()){
         auto *ptype = type_to_llvm(type->get_oftype());
         auto *vtype = ptype->getPointerTo();
-        loggedinfo.addVariable(var, vtype, nullptr);
-        loggedinfo.pointerType(var, ptype);
+        cx->loggedinfo.addVariable(var, vtype, nullptr, get_symbol(k++));
+        cx->loggedinfo.pointerType(var, ptype);
       }
       
       return nullptr;
     }
-    for (std::string var : id_list->getlist()){  // this is for everything not array, pointer
+    size_t k = 0;
+    for (Name var : id_list->getlist()){  // this is for everything not array, pointer
       
       auto *vtype = type_to_llvm(type->get_type());
-      auto *valloca = Builder.CreateAlloca(vtype, nullptr, var); 
+      auto *valloca = cx->Builder.CreateAlloca(vtype, nullptr, var.str()); 
       //log variable
-      loggedinfo.addVariable(var, vtype, valloca);
+      cx->loggedinfo.addVariable(var, vtype, valloca, get_symbol(k++));
     }
     return nullptr;
   }
@@ -3017,6 +2908,7 @@ private:
   Id *id;
   Id_list *id_list;
   Type_not_from_llvm *type;
+  std::vector<Symbol *> symbols;
 };
 
 
@@ -3024,14 +2916,10 @@ class Decl_list: public AST {
 public:
   Decl_list(){
     
-  }
-  ~Decl_list(){
-    for (Decl *d : decl_list) { delete d; }
   }
   void append (Decl *d) {
-    decl_list.push_back(d);
+    if (d) decl_list.push_back(d);
   }
-  void append_first(Decl *d) { decl_list.insert(decl_list.begin(), d); }
   virtual void printOn(std::ostream &out) const override {
     out << "Decl_list(";
     for (Decl *d : decl_list) {
@@ -3081,27 +2969,30 @@ public:
   virtual void set_type(Types t){
     type = t;
   }
+  virtual Name get_id() const = 0;
+  // the symbol of the procedure or function (set by sem)
+  Symbol *get_symbol() const {
+    return sym;
+  }
+protected:
+  Symbol *sym = nullptr;
 private:
 	Types type;
 };
 
 class Procedure: public Header {
 public:
-  Procedure(char const *i, Formal *f, Formal_list *fl){
+  Procedure(Name i, Formal_list *fl){
     id = i;
     formal_list = fl;
-    if (f) formal_list->append_first(f);
     forward = false;
   }
-  Procedure(char* i){
+  Procedure(Name i){
     id = i;
     formal_list = nullptr;
     forward = false;
   }
-  ~Procedure(){
-    delete id;
-    delete formal_list;
-  }
+  virtual Name get_id() const override { return id; }
   virtual void printOn(std::ostream &out) const override {
     out << "Procedure(" << id << ",";
     if (formal_list) formal_list->printOn(out);
@@ -3110,7 +3001,7 @@ public:
   virtual std::string getstring() override {
     std::string s = "";
     s += "Procedure(";
-    s += std::string(id);
+    s += id.str();
     s += ",";
     if (formal_list) s += formal_list->getstring();
     s += ")";
@@ -3130,58 +3021,55 @@ public:
   }
   virtual void semfor() override {
     forward = true;
-    std::string s = id;
-    st.insertProcedure(s, TYPE_proc, formal_list, forward);
+    Name s = id;
+    cx->st.insertProcedure(s, TYPE_proc, formal_list, forward);
   }
   virtual void sem() override {
-    std::string s = id;
-    if (st.foundForward(s)) {
+    Name s = id;
+    if (cx->st.foundForward(s)) {
       std::string forward_decl;
       std::string current_decl;
-      forward_decl = st.getFormalsProcedureAll(s)->getstring();
+      forward_decl = cx->st.getFormalsProcedureAll(s)->getstring();
       current_decl = formal_list->getstring();
       if (forward_decl.compare(current_decl)){
-        std::cerr << "ERROR in procedure " << s << ". It was forward declared with arguments " << forward_decl << " but now it has arguments " << current_decl << "\n";
-        exit(1);
+        diag().error() << "ERROR in procedure " << s << ". It was forward declared with arguments " << forward_decl << " but now it has arguments " << current_decl << "\n";
+        return;
       }
-      st.clearForDecl(s);
-      st.insertParent(s);
+      cx->st.clearForDecl(s);
+      cx->st.insertParent(s);
     }
     else {
-      st.insertProcedure(s, TYPE_proc, formal_list, forward);
+      cx->st.insertProcedure(s, TYPE_proc, formal_list, forward);
     }
+    sym = cx->st.lookupSymbol(s);
   }
   virtual Value* compile() const override { 
-    std::string pname = id;
-    loggedinfo.pushProc(pname);
-    loggedinfo.addProcFormals(pname,formal_list);
+    Name pname = id;
+    cx->loggedinfo.pushProc(pname);
+    cx->loggedinfo.addProcFormals(pname,formal_list);
     return nullptr;
   }
 private:
-  char const *id;
+  Name id;
   Formal_list *formal_list;
   bool forward;
 };
 
 class Function_not_from_llvm: public Header {
 public:
-  Function_not_from_llvm(char const *i, Formal *f, Formal_list *fl, Type_not_from_llvm *t){
+  Function_not_from_llvm(Name i, Formal_list *fl, Type_not_from_llvm *t){
     id = i;
     formal_list = fl;
-    if (f) fl->append_first(f);
     type = t;
     forward = false;
   }
-  Function_not_from_llvm(char const *i, Type_not_from_llvm *t){
+  Function_not_from_llvm(Name i, Type_not_from_llvm *t){
     id = i;
     formal_list = nullptr;
     type = t;
     forward = false;
   }
-  ~Function_not_from_llvm(){
-    delete id;
-    delete formal_list;
-  }
+  virtual Name get_id() const override { return id; }
   virtual void printOn(std::ostream &out) const override {
     out << "Function(" << id << "," << type->get_type() << ",";
     if (formal_list) formal_list->printOn(out);
@@ -3212,56 +3100,57 @@ public:
   }
   virtual void semfor() override {
     forward = true;
-    std::string s = id;
-    st.insertFunction(s, type->get_type(), formal_list, forward);
+    Name s = id;
+    cx->st.insertFunction(s, type->get_type(), formal_list, forward);
   }
   virtual void sem() override {
-    std::string s = id;
+    Name s = id;
     if (type->get_type() == TYPE_array){
-      std::cerr << "ERROR: Function " << s << " can not be of type ARRAY!";
-      exit(1);
+      diag().error() << "ERROR: Function " << s << " can not be of type ARRAY!";
+      return;
     }
-    if (st.foundForward(s)){
+    if (cx->st.foundForward(s)){
       std::string forward_decl;
       std::string current_decl;
-      if (st.getFormalsFuncAll(s)){
+      if (cx->st.getFormalsFuncAll(s)){
       	if (formal_list){
-      		forward_decl = st.getFormalsFuncAll(s)->getstring();
+      		forward_decl = cx->st.getFormalsFuncAll(s)->getstring();
 	        current_decl = formal_list->getstring();
 	        if (forward_decl.compare(current_decl)){
-	          std::cerr << "ERROR in function " << s << ". It was forward declared with arguments " << forward_decl << " but now it has arguments " << current_decl << "\n";
-	          exit(1);
+	          diag().error() << "ERROR in function " << s << ". It was forward declared with arguments " << forward_decl << " but now it has arguments " << current_decl << "\n";
+	          return;
 	        }
-	        st.clearForDecl(s);
-	        st.insertParent(s);
+	        cx->st.clearForDecl(s);
+	        cx->st.insertParent(s);
 	        // formal_list->sem();
       	}
       	else{
-      		forward_decl = st.getFormalsFuncAll(s)->getstring();
-      		std::cerr << "ERROR in function " << s << ". It was forward declared with arguments " << forward_decl << " but now it has no arguments\n";
-	        exit(1);
+      		forward_decl = cx->st.getFormalsFuncAll(s)->getstring();
+      		diag().error() << "ERROR in function " << s << ". It was forward declared with arguments " << forward_decl << " but now it has no arguments\n";
+	        return;
       	}
       }
       else{
-      	st.clearForDecl(s);
-      	st.insertParent(s);
+      	cx->st.clearForDecl(s);
+      	cx->st.insertParent(s);
       }
     }
     else {
       if (formal_list){
-        st.insertFunction(s, type->get_type(), formal_list, forward);
+        cx->st.insertFunction(s, type->get_type(), formal_list, forward);
       }
       else{
       	
-        st.insertFunction(s, type->get_type(), formal_list, forward);
+        cx->st.insertFunction(s, type->get_type(), formal_list, forward);
       }
     }
+    sym = cx->st.lookupSymbol(s);
   }
   virtual Value* compile() const override {
 
-  	std::string fname = id;
-    loggedinfo.pushFunc(fname);
-    loggedinfo.addFuncFormals(fname,formal_list);
+  	Name fname = id;
+    cx->loggedinfo.pushFunc(fname);
+    cx->loggedinfo.addFuncFormals(fname,formal_list);
     llvm::Type *retType;
     if (type->get_type() == TYPE_array){
       retType = type_to_llvm(type->get_oftype());		// this should be unreachable
@@ -3272,11 +3161,11 @@ public:
     else{
       retType = type_to_llvm(type->get_type());  
     }
-    loggedinfo.addFuncType(fname,retType);
+    cx->loggedinfo.addFuncType(fname,retType);
     return nullptr;
   }
 private:
-  char const *id;
+  Name id;
   Type_not_from_llvm *type;
   Formal_list *formal_list;
   bool forward;
@@ -3356,6 +3245,7 @@ public:
     }
     else if (type.compare("func_proc") == 0){
       header->sem();
+      TraceEvent e("sem", "Body::sem", header->get_id());
       body->sem();
     }
     else if (type.compare("forward") == 0){
@@ -3363,6 +3253,8 @@ public:
     }
   }
   virtual Value* compile() const override {
+    bool named = type.compare("func_proc") == 0 or type.compare("forward") == 0;
+    TraceEvent e("irgen", "Local::compile", type, named ? header->get_id() : Name());
     if(type.compare("var") == 0){
       decl_list->compile();
     }
@@ -3372,6 +3264,11 @@ public:
     else if (type.compare("func_proc") == 0){
       header->compile();
       body->compile();
+      // calls to it compile without looking it up from now on
+      if (Symbol *sym = header->get_symbol()) {
+        Name id = header->get_id();
+        sym->function = header->get_type() == TYPE_proc ? cx->loggedinfo.getProcInScope(id) : cx->loggedinfo.getFunctionInScope(id);
+      }
     }
     else if(type.compare("forward") == 0){
       header->compile();
@@ -3390,11 +3287,6 @@ private:
 class Local_list: public AST {
 public:
   Local_list(){}
-  ~Local_list() {
-    for (Local *l : local_list) {
-      delete l;
-    }
-  }
   virtual void printOn(std::ostream &out) const override {
     out << "Local_list(";
     for (Local *l : local_list) {
@@ -3418,13 +3310,12 @@ public:
   void append(Local *l) {
     local_list.push_back(l);
   }
-  void append_first(Local *l) { local_list.insert(local_list.begin(), l); }
   virtual void sem() override {
     for (Local *l : local_list) {
       l->sem();
     }
   }
-  std::vector<Local *> getlist() {
+  const std::vector<Local *> &getlist() const {
     return local_list;
   }
 
@@ -3457,7 +3348,6 @@ public:
     block = b;
     size = 0;
   }
-  ~Body(){ delete local_list; };
   virtual void printOn(std::ostream &out) const override {
     out << "Body(";
     if (local_list) local_list->printOn(out);
@@ -3474,25 +3364,26 @@ public:
     return s;
   }
   virtual void sem() override {
-    st.openScope();
+    cx->st.openScope();
     local_list->sem();
     block->sem();
-    size = st.getSizeOfCurrentScope();
-    st.closeScope();
+    size = cx->st.getSizeOfCurrentScope();
+    cx->st.closeScope();
   }
   virtual Value* compile() const override {
     
 
-    if ((loggedinfo.isFuncStackEmpty()) and (loggedinfo.isProcStackEmpty())){ // this is our main's body
-      llvm::Function * main = loggedinfo.getFunctionInScope("main");
+    if ((cx->loggedinfo.isFuncStackEmpty()) and (cx->loggedinfo.isProcStackEmpty())){ // this is our main's body
+      TraceEvent e("irgen", "Body::compile", NAME_main);
+      llvm::Function * main = cx->loggedinfo.getFunctionInScope(NAME_main);
   	  std::vector<Local *> list;
   	  list = local_list->getProcFuncDecl();
   	  for (Local *l : list){
   	  	l->compile();
   	  }
   	  
-      BasicBlock *BB = BasicBlock::Create(TheContext, "entry", main);
-      Builder.SetInsertPoint(BB);
+      BasicBlock *BB = BasicBlock::Create(cx->TheContext, "entry", main);
+      cx->Builder.SetInsertPoint(BB);
       
       local_list->compile();
 
@@ -3500,37 +3391,39 @@ public:
       
       block->compile();
 
-      Builder.CreateRet(c32(0));
+      cx->Builder.CreateRet(c32(0));
 
-      if (llvm::verifyFunction(*main, &llvm::errs())) {std::cerr << "Somethings wrong! LLVM couldn't verify Function\n";}
-      loggedinfo.closeScope();
+      if (verify(main)) {std::cerr << "Somethings wrong! LLVM couldn't verify Function\n";}
+      cx->loggedinfo.closeScope();
       return nullptr;
     }
-    else if (!(loggedinfo.isProcStackEmpty())){ //this is the body of a procedure
+    else if (!(cx->loggedinfo.isProcStackEmpty())){ //this is the body of a procedure
       std::vector<Formal *> params;
       Formal_list * fl;
-      std::string pname = loggedinfo.getLastProc();
-      std::vector<std::string> parameterNames;
+      Name pname = cx->loggedinfo.getLastProc();
+      TraceEvent e("irgen", "Body::compile", pname);
+      std::vector<Name> parameterNames;
+      std::vector<Symbol *> parameterSymbols;
       std::vector<llvm::Type *> parameterTypes;
-      if (loggedinfo.getProcFormals(pname)){
-        fl = loggedinfo.getProcFormals(pname);
+      if (cx->loggedinfo.getProcFormals(pname)){
+        fl = cx->loggedinfo.getProcFormals(pname);
         params = fl->getlist(); 
       }
       
-      std::vector<std::string> outerScopeVarsNames;
-      unordered_map<std::string, llvm::Type *> outerScopeVarsTypes;
-      unordered_map<std::string, llvm::AllocaInst*> outerScopeVarsAllocas;
-      llvm::Type *retType = Type::getVoidTy(TheContext);
+      std::vector<Name> outerScopeVarsNames;
+      unordered_map<Name, llvm::Type *> outerScopeVarsTypes;
+      unordered_map<Name, llvm::AllocaInst*> outerScopeVarsAllocas;
+      llvm::Type *retType = Type::getVoidTy(cx->TheContext);
 
-      if (loggedinfo.getProcFormals(pname)){
+      if (cx->loggedinfo.getProcFormals(pname)){
         // first log param types and names
         for (Formal *f : params){
 
-          std::vector<std::string> id_list;
-          id_list = f->getIdList();
-          for (std::string name : id_list){
-            // std::string name = id;
+          const std::vector<Name> &id_list = f->getIdList();
+          size_t k = 0;
+          for (Name name : id_list){
             parameterNames.push_back(name);
+            parameterSymbols.push_back(f->get_symbol(k++));
             if (f->get_type() == TYPE_array){
               parameterTypes.push_back(type_to_llvm(f->get_oftype(),f->getby(), true));
             }
@@ -3542,16 +3435,18 @@ public:
       }
 
       // then add references to outer scope variables as parameters
-      outerScopeVarsTypes = loggedinfo.getCurrentScopeVarTypes();
-      outerScopeVarsAllocas = loggedinfo.getCurrentScopeVarAllocas();
+      outerScopeVarsTypes = cx->loggedinfo.getCurrentScopeVarTypes();
+      outerScopeVarsAllocas = cx->loggedinfo.getCurrentScopeVarAllocas();
       for (auto var: outerScopeVarsTypes) outerScopeVarsNames.push_back(var.first);
 
       llvm::Type *varType;
-      for (std::string var : outerScopeVarsNames) {
+      for (Name var : outerScopeVarsNames) {
         // skip shadowed outer scope variables
         if (find(parameterNames.begin(), parameterNames.end(), var) != parameterNames.end()) continue;
         varType = outerScopeVarsTypes[var];
         parameterNames.push_back(var);
+        // the declaration it is bound to out here is the one the body refers to
+        parameterSymbols.push_back(cx->loggedinfo.getCurrentScopeSymbol(var));
         // if var is pointer, leave it as it is
         if (varType->isPointerTy())
           parameterTypes.push_back(varType);
@@ -3561,31 +3456,31 @@ public:
       }
 
       llvm::FunctionType *PT = llvm::FunctionType::get(retType, parameterTypes, false);
-      llvm::Function *P = llvm::Function::Create(PT, llvm::Function::ExternalLinkage, pname, TheModule.get());
+      llvm::Function *P = llvm::Function::Create(PT, llvm::Function::ExternalLinkage, pname.str(), cx->TheModule.get());
 
-      loggedinfo.addProcInScope(pname, P);
+      cx->loggedinfo.addProcInScope(pname, P);
 
-      loggedinfo.openScope();
+      cx->loggedinfo.openScope();
       // now, let's set all param names
       unsigned Idx = 0;
-      for (auto &arg : P->args()) arg.setName(parameterNames[Idx++]);
+      for (auto &arg : P->args()) arg.setName(parameterNames[Idx++].str());
 
-      llvm::BasicBlock *BB = llvm::BasicBlock::Create(TheContext, "", P);
-      Builder.SetInsertPoint(BB);
+      llvm::BasicBlock *BB = llvm::BasicBlock::Create(cx->TheContext, "", P);
+      cx->Builder.SetInsertPoint(BB);
 
       // create allocas for params
+      Idx = 0;
       for (auto &arg : P->args()) {
-        auto *alloca = Builder.CreateAlloca(arg.getType(), nullptr, arg.getName().str());
-        Builder.CreateStore(&arg, alloca);
-        loggedinfo.addVariable(arg.getName().str(), arg.getType(), alloca);
+        auto *alloca = cx->Builder.CreateAlloca(arg.getType(), nullptr, arg.getName());
+        cx->Builder.CreateStore(&arg, alloca);
+        cx->loggedinfo.addVariable(nameOf(arg), arg.getType(), alloca, parameterSymbols[Idx++]);
       }
 
       // compile local_list
-      std::vector<Local *> local_definitions;
-      local_definitions = local_list->getlist();
+      const std::vector<Local *> &local_definitions = local_list->getlist();
       for (Local *l : local_definitions){
         l->compile();
-        Builder.SetInsertPoint(BB);
+        cx->Builder.SetInsertPoint(BB);
       }
 
       // compile block of statements
@@ -3594,15 +3489,15 @@ public:
       // check if the instruction "return" terminates our block
       if (!BB->getTerminator()){
       	// llvm::ReturnInst *ret;
-    		Builder.CreateRetVoid();
+    		cx->Builder.CreateRetVoid();
       	//exit(1);
       }
-      if (llvm::verifyFunction(*P, &llvm::errs())) {
+      if (verify(P)) {
         std::cerr << "Somethings wrong! LLVM couldn't verify Procedure " << pname <<"\n";
         exit(1);
       }
-      loggedinfo.closeScope();
-      loggedinfo.removeCurrProc();
+      cx->loggedinfo.closeScope();
+      cx->loggedinfo.removeCurrProc();
       
       return nullptr;
 
@@ -3610,42 +3505,46 @@ public:
     }
     else { //this is the body of a function
 
-	    std::string fname = loggedinfo.getLastFunc();
+	    Name fname = cx->loggedinfo.getLastFunc();
+      TraceEvent e("irgen", "Body::compile", fname);
       Formal_list * fl;
-      llvm::Type *retType = loggedinfo.getFuncType(fname);
+      llvm::Type *retType = cx->loggedinfo.getFuncType(fname);
       std::vector<Formal *> params;
-      std::vector<std::string> parameterNames;
+      std::vector<Name> parameterNames;
+      std::vector<Symbol *> parameterSymbols;
       std::vector<llvm::Type *> parameterTypes;
-      std::vector<std::string> outerScopeVarsNames;
-      unordered_map<std::string, llvm::Type *> outerScopeVarsTypes;
-      unordered_map<std::string, llvm::AllocaInst*> outerScopeVarsAllocas;
+      std::vector<Name> outerScopeVarsNames;
+      unordered_map<Name, llvm::Type *> outerScopeVarsTypes;
+      unordered_map<Name, llvm::AllocaInst*> outerScopeVarsAllocas;
       
-      if (loggedinfo.getFuncFormals(fname)){
-        fl = loggedinfo.getFuncFormals(fname);
+      if (cx->loggedinfo.getFuncFormals(fname)){
+        fl = cx->loggedinfo.getFuncFormals(fname);
         params = fl->getlist();
         // first log param types and names
         for (Formal *f : params){
-          std::vector<std::string> id_list;
-          id_list = f->getIdList();
-          for (std::string name : id_list){
-            // std::string name = id;
+          const std::vector<Name> &id_list = f->getIdList();
+          size_t k = 0;
+          for (Name name : id_list){
             parameterNames.push_back(name);
+            parameterSymbols.push_back(f->get_symbol(k++));
             parameterTypes.push_back(type_to_llvm(f->get_type(),f->getby()));
           }
         }
       }
 
       // then add references to outer scope variables as parameters
-      outerScopeVarsTypes = loggedinfo.getCurrentScopeVarTypes();
-      outerScopeVarsAllocas = loggedinfo.getCurrentScopeVarAllocas();
+      outerScopeVarsTypes = cx->loggedinfo.getCurrentScopeVarTypes();
+      outerScopeVarsAllocas = cx->loggedinfo.getCurrentScopeVarAllocas();
       for (auto var: outerScopeVarsTypes) outerScopeVarsNames.push_back(var.first);
 
       llvm::Type *varType;
-      for (std::string var : outerScopeVarsNames) {
+      for (Name var : outerScopeVarsNames) {
         // skip shadowed outer scope variables
         if (find(parameterNames.begin(), parameterNames.end(), var) != parameterNames.end()) continue;
         varType = outerScopeVarsTypes[var];
         parameterNames.push_back(var);
+        // the declaration it is bound to out here is the one the body refers to
+        parameterSymbols.push_back(cx->loggedinfo.getCurrentScopeSymbol(var));
         // if var is pointer, leave it as it is
         if (varType->isPointerTy())
           parameterTypes.push_back(varType);
@@ -3655,60 +3554,59 @@ public:
       }
 
       llvm::FunctionType *FT = llvm::FunctionType::get(retType, parameterTypes, false);
-      llvm::Function *F = llvm::Function::Create(FT, llvm::Function::ExternalLinkage, fname, TheModule.get());
+      llvm::Function *F = llvm::Function::Create(FT, llvm::Function::ExternalLinkage, fname.str(), cx->TheModule.get());
 
-      loggedinfo.addFunctionInScope(fname, F);
+      cx->loggedinfo.addFunctionInScope(fname, F);
 
-      loggedinfo.openScope();
+      cx->loggedinfo.openScope();
 
 
       //this is necessary for result assignment
-      loggedinfo.pushFunc(fname);
+      cx->loggedinfo.pushFunc(fname);
       // now, let's set all param names
       unsigned Idx = 0;
-      for (auto &arg : F->args()) arg.setName(parameterNames[Idx++]);
+      for (auto &arg : F->args()) arg.setName(parameterNames[Idx++].str());
 
-      llvm::BasicBlock *BB = llvm::BasicBlock::Create(TheContext, "", F);
-      llvm::BasicBlock *EndOfFunc = llvm::BasicBlock::Create(TheContext, "endfunc", F);
-      Builder.SetInsertPoint(BB);
+      llvm::BasicBlock *BB = llvm::BasicBlock::Create(cx->TheContext, "", F);
+      llvm::BasicBlock *EndOfFunc = llvm::BasicBlock::Create(cx->TheContext, "endfunc", F);
+      cx->Builder.SetInsertPoint(BB);
 
-      loggedinfo.storeEndOfFunc(fname, EndOfFunc);
-      std::string var = "result";
-      auto *valloca = Builder.CreateAlloca(retType, nullptr, var); 
+      cx->loggedinfo.storeEndOfFunc(fname, EndOfFunc);
+      auto *valloca = cx->Builder.CreateAlloca(retType, nullptr, "result"); 
       //log result variable
-      loggedinfo.addVariable(var, retType, valloca);
+      cx->loggedinfo.addVariable(NAME_result, retType, valloca);
 
       // create allocas for params
+      Idx = 0;
       for (auto &arg : F->args()) {
-        auto *alloca = Builder.CreateAlloca(arg.getType(), nullptr, arg.getName().str());
-        Builder.CreateStore(&arg, alloca);
-        loggedinfo.addVariable(arg.getName().str(), arg.getType(), alloca);
+        auto *alloca = cx->Builder.CreateAlloca(arg.getType(), nullptr, arg.getName());
+        cx->Builder.CreateStore(&arg, alloca);
+        cx->loggedinfo.addVariable(nameOf(arg), arg.getType(), alloca, parameterSymbols[Idx++]);
       }
 
       // compile local_list
-      std::vector<Local *> local_definitions;
-      local_definitions = local_list->getlist();
+      const std::vector<Local *> &local_definitions = local_list->getlist();
       for (Local *l : local_definitions){
         l->compile();
-        Builder.SetInsertPoint(BB);
+        cx->Builder.SetInsertPoint(BB);
       }
 
       // compile block of statements
       block->compile();
 
       // create result return
-      Builder.CreateBr(EndOfFunc);
-      Builder.SetInsertPoint(EndOfFunc);
-      llvm::Value * result = Builder.CreateLoad(calcAddr("result", "Id"));
-      Builder.CreateRet(result);
+      cx->Builder.CreateBr(EndOfFunc);
+      cx->Builder.SetInsertPoint(EndOfFunc);
+      llvm::Value * result = cx->Builder.CreateLoad(calcAddr(NAME_result, "Id"));
+      cx->Builder.CreateRet(result);
 
-      if (llvm::verifyFunction(*F, &llvm::errs())) {
+      if (verify(F)) {
         std::cerr << "Somethings wrong!LLVM couldn't verify Function " << fname << "\n";
         exit(1);
       }
-      loggedinfo.removeCurrFunc();
-      loggedinfo.closeScope();
-      loggedinfo.removeCurrFunc();
+      cx->loggedinfo.removeCurrFunc();
+      cx->loggedinfo.closeScope();
+      cx->loggedinfo.removeCurrFunc();
       return nullptr;
     }
   }
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include "arena.hpp"
+#include "diagnostics.hpp"
+#include "symbol.hpp"
+#include "llvm.hpp"
+
+/* ---------------------------------------------------------------------
+   ---------------------------- Compilations ---------------------------
+   ---------------------------------------------------------------------
+   The state of compiling one program: the scanner, the parser and the
+   AST reach it through cx, not through globals, so a process can hold
+   more than one. Running them on separate threads at the same time is
+   not safe yet, since these are still process wide:
+     the options (driver.hpp),
+     the --time-report and --trace recorders (timing.cpp, trace.cpp),
+     and the error exits: Diagnostics::error() past --error-limit and
+     stopIfFailed() end the process with exit(1), and so do the codegen
+     errors in ast.hpp and llvm.hpp,
+   so one failing compilation ends them all.
+   The AST reaches the compilation running on its thread through cx.
+   > arena:         the AST and type nodes, all freed when it ends
+   > diagnostics:   the errors reported so far (see diag())
+   > st:            symbol table of the semantic analysis
+   > loggedinfo:    scopes and functions logged for the code generation
+   > rt_stack:      values of the constant evaluator
+   > scalarTypes,
+     arrayTypes,
+     pointerTypes:  the canonical type nodes (see Int::get() in ast.hpp)
+   > TheContext,
+     Builder,
+     TheModule:     LLVM state of the program being compiled
+   > The*:          runtime library functions declared in TheModule
+   > i1 ... X86_FP80TyID: LLVM types of TheContext used by the AST
+   > scanner:       the (reentrant) flex scanner of the source
+   > source,
+     sourceSize,
+     sourceMapped:  the source, mapped or read into memory (see openSource)
+   > line,
+     lineStart:     line of the scanner and where it starts in source
+ ----------------------------------------------------------------------- */
+
+class AST;
+class Type_not_from_llvm;
+
+class Compilation {
+public:
+  Compilation()
+    : Builder(TheContext),
+      i1(llvm::IntegerType::get(TheContext, 1)),
+      i8(llvm::IntegerType::get(TheContext, 8)),
+      i32(llvm::IntegerType::get(TheContext, 32)),
+      i64(llvm::IntegerType::get(TheContext, 64)),
+      X86_FP80TyID(llvm::Type::getX86_FP80Ty(TheContext)) {}
+  Compilation(const Compilation &) = delete;
+  Compilation &operator=(const Compilation &) = delete;
+
+  // lex, parse, check and compile the source file (stdin when path is
+  // empty or "-") on the calling thread, returns the parser's status
+  int run(const std::string &path);
+
+  Arena<AST> arena;
+  Diagnostics diagnostics;
+  SymbolTable st;
+  LoggedInfo loggedinfo;
+  std::vector<int> rt_stack;
+
+  Type_not_from_llvm *scalarTypes[TYPE_error + 1] = {};
+  std::map<std::pair<Types, int>, Type_not_from_llvm *> arrayTypes;
+  Type_not_from_llvm *pointerTypes[TYPE_error + 1] = {};
+
+  llvm::LLVMContext TheContext;
+  llvm::IRBuilder<> Builder;
+  std::unique_ptr<llvm::Module> TheModule;
+
+  llvm::Function *TheWriteInteger = nullptr;
+  llvm::Function *TheWriteBoolean = nullptr;
+  llvm::Function *TheWriteChar = nullptr;
+  llvm::Function *TheWriteReal = nullptr;
+  llvm::Function *TheWriteString = nullptr;
+  llvm::Function *TheReadInteger = nullptr;
+  llvm::Function *TheReadBoolean = nullptr;
+  llvm::Function *TheReadChar = nullptr;
+  llvm::Function *TheReadString = nullptr;
+  llvm::Function *TheAbs = nullptr;
+  llvm::Function *TheFabs = nullptr;
+  llvm::Function *TheSqrt = nullptr;
+  llvm::Function *TheSin = nullptr;
+  llvm::Function *TheCos = nullptr;
+  llvm::Function *TheTan = nullptr;
+  llvm::Function *TheArctan = nullptr;
+  llvm::Function *TheExp = nullptr;
+  llvm::Function *ThePi = nullptr;
+  llvm::Function *TheLn = nullptr;
+  llvm::Function *TheTrunc = nullptr;
+  llvm::Function *TheRound = nullptr;
+  llvm::Function *TheOrd = nullptr;
+  llvm::Function *TheChr = nullptr;
+
+  llvm::Type *i1;
+  llvm::Type *i8;
+  llvm::Type *i32;
+  llvm::Type *i64;
+  llvm::Type *X86_FP80TyID;
+
+  void *scanner = nullptr;
+  char *source = nullptr;
+  size_t sourceSize = 0;
+  bool sourceMapped = false;
+  int line = 1;
+  const char *lineStart = nullptr;
+};
+
+// the compilation running on this thread (set by Compilation::run)
+extern thread_local Compilation *cx;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+/* ---------------------------------------------------------------------
+   ----------------------------- Diagnostics ---------------------------
+   ---------------------------------------------------------------------
+   Errors are reported and counted, and the compilation goes on so that
+   one run reports as many of them as it can: the parser resynchronizes
+   on its error rules, the semantic analysis skips the rest of the node
+   at fault. Nothing is generated once an error has been reported.
+   > limit:   stop after that many errors (--error-limit, 0 is no limit)
+   > count:   errors reported so far
+ ----------------------------------------------------------------------- */
+
+class Diagnostics {
+public:
+  unsigned limit = 20;
+
+  // count a new error and return the stream to write it on (give up
+  // instead when the limit has been reached)
+  std::ostream &error() {
+    if (limit != 0 and count == limit) {
+      std::cerr << "ERROR: too many errors, stopping\n";
+      exit(1);
+    }
+    ++count;
+    return std::cerr;
+  }
+
+  unsigned errors() const { return count; }
+  bool failed() const { return count != 0; }
+
+  // give up if any error has been reported
+  void stopIfFailed() const {
+    if (!failed()) return;
+    std::cerr << count << (count == 1 ? " error" : " errors") << " found\n";
+    exit(1);
+  }
+
+private:
+  unsigned count = 0;
+};
+
+// the diagnostics of the compilation running on this thread
+Diagnostics &diag();
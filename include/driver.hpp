@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <llvm/IR/Module.h>
+
+/* ---------------------------------------------------------------------
+   ------------------------------- Options -----------------------------
+   ---------------------------------------------------------------------
+   > infile:      PCL source file (empty means stdin)
+   > progname:    name used for the .imm/.asm dumps and temporary files
+   > basedir:     directory where the .imm/.asm dumps are stored
+   > outname:     name of the produced executable (or object with -c, or
+                  bitcode with --emit=bc, where it defaults to <progname>.bc)
+   > runtime:     path of the PCL runtime library (lib.a)
+   > optLevel:    optimization level, 0 to 3 (-O0 to -O3, -O is -O3)
+   > sizeLevel:   1 when optimizing for size (-Os, which implies -O2)
+   > dump:        store IR and assembly in .imm/.asm files (off with -x)
+   > dumpIR:      print IR to stdout, then exit (-i)
+   > dumpFinal:   print assembly to stdout, then exit (-f)
+   > compileOnly: stop after emitting the object file (-c, --emit=obj)
+   > bitcode:     write the optimized module as bitcode, nothing else (--emit=bc)
+   > jit:         run the program in-process instead of linking it (--jit)
+   > timeReport:  "table" or "json" to print the time report (--time-report)
+   > trace:       file to write Chrome trace events to (--trace=FILE)
+   > errorLimit:  stop after that many errors, 0 for no limit (--error-limit=N)
+   > stopAfter:   "lex" to only scan the source and print its token count,
+                  "parse" to only parse it (--stop-after=PHASE, see bench/)
+   > server:      socket to serve compile requests on (--server), see server.hpp
+ ----------------------------------------------------------------------- */
+
+struct Options {
+  std::string infile;
+  std::string progname = "pcl_from_stdin";
+  std::string basedir;
+  std::string outname;
+  std::string runtime;
+  unsigned optLevel = 0;
+  unsigned sizeLevel = 0;
+  bool dump = true;
+  bool dumpIR = false;
+  bool dumpFinal = false;
+  bool compileOnly = false;
+  bool bitcode = false;
+  bool jit = false;
+  std::string timeReport;
+  std::string trace;
+  unsigned errorLimit = 20;
+  std::string stopAfter;
+  std::string server;
+};
+
+extern Options options;
+
+// fill in the global options from the command line (exits on bad usage)
+void parseOptions(int argc, char **argv);
+
+// compile one program (stdin when path is empty or "-") in a compilation
+// of its own, see compilation.hpp; returns the parser's status
+int compileProgram(const std::string &path);
+
+// register the native target, its assembly printer and parser
+void initializeBackend();
+
+// optimize, dump, emit the object code and link the final executable
+// (or, with --jit, run the program and exit with its status)
+void runBackend(std::unique_ptr<llvm::Module> M);
@@ -34,7 +34,6 @@ char * escapeString (char *s);
    --------------     ---------------
    --------------------------------------------------------------------- */
 
-extern int linecount;
 extern int sem_failed;
 
 #endif
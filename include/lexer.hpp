@@ -1,7 +1,25 @@
 #ifndef __LEXER_HPP__
 #define __LEXER_HPP__
 
-int yylex();
+#include <cstdio>
+#include <string>
+
+// the scanner and the parser are reentrant, all their state is in a
+// scanner handle (whose extra data is the Compilation it reads for)
+typedef void *yyscan_t;
+union YYSTYPE;
+class Compilation;
+
+int yylex_init_extra(Compilation *c, yyscan_t *scanner);
+int yylex_destroy(yyscan_t scanner);
+
+// scan the given source file (mapped in place), stdin when path is empty or "-"
+void openSource(const std::string &path, yyscan_t scanner);
+// release what openSource acquired
+void closeSource(yyscan_t scanner);
+
+int yylex(YYSTYPE *lvalp, yyscan_t scanner);
+int yyparse(yyscan_t scanner);
 void yyerror(const char *msg);
 
 #endif
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <string>
 #include <unordered_map>
 #include <stack>
@@ -5,6 +7,7 @@
 #include <typeinfo>
 
 #include "ast.hpp"
+#include "name.hpp"
 
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
@@ -24,6 +27,12 @@ using namespace std;
 
 void llvm_compile_and_dump();
 
+// the Name of an LLVM value (an argument), without a std::string copy
+inline Name nameOf(const llvm::Value &v) {
+  llvm::StringRef s = v.getName();
+  return Name(s.data(), s.size());
+}
+
 class Formal_list;
 
 /* ---------------------------------------------------------------------
@@ -38,24 +47,36 @@ class Formal_list;
    > labelsbody:        all bodies of labels
    > labelscont:        all blocks after stmts of a label
    > FunctionsNoBody:         stack of the names of all functions with no body declared yet
+   > symbols:           symbols of the variables bound in this scope
+   > rebound:           what bind() overwrote, restored when the scope closes
  ----------------------------------------------------------------------- */
 
+// the LLVM side a symbol had before it was bound again
+struct Rebinding {
+    Symbol *symbol;
+    llvm::Type *type;
+    llvm::AllocaInst *alloca;
+    size_t depth;
+};
+
 typedef struct {
-    unordered_map<string, llvm::Type*> variableTypes;
-    unordered_map<string, llvm::Type*> pointerTypes;
-    unordered_map<string, llvm::Type*> arrayTypes;
-    unordered_map<string, llvm::Type*> FuncTypes;
-    unordered_map<string, llvm::AllocaInst*> variableAllocas;
-    unordered_map<string, llvm::Function*> functions;
-    unordered_map<string, llvm::BasicBlock*> functions_ends;
-    unordered_map<string, llvm::Function*> procedures;
-    unordered_map<string, llvm::Value*> FunctionsResults;
-    unordered_map<string, llvm::BasicBlock*> labelsbody;
-    unordered_map<string, llvm::BasicBlock*> labelscont;
-    stack<string> FunctionsNoBody;
-    stack<string> ProcsNoBody;
-    unordered_map<string, Formal_list *> ProcsFormals;
-    unordered_map<string, Formal_list *> FuncsFormals;
+    unordered_map<Name, llvm::Type*> variableTypes;
+    unordered_map<Name, llvm::Type*> pointerTypes;
+    unordered_map<Name, llvm::Type*> arrayTypes;
+    unordered_map<Name, llvm::Type*> FuncTypes;
+    unordered_map<Name, llvm::AllocaInst*> variableAllocas;
+    unordered_map<Name, llvm::Function*> functions;
+    unordered_map<Name, llvm::BasicBlock*> functions_ends;
+    unordered_map<Name, llvm::Function*> procedures;
+    unordered_map<Name, llvm::Value*> FunctionsResults;
+    unordered_map<Name, llvm::BasicBlock*> labelsbody;
+    unordered_map<Name, llvm::BasicBlock*> labelscont;
+    stack<Name> FunctionsNoBody;
+    stack<Name> ProcsNoBody;
+    unordered_map<Name, Formal_list *> ProcsFormals;
+    unordered_map<Name, Formal_list *> FuncsFormals;
+    unordered_map<Name, Symbol *> symbols;
+    vector<Rebinding> rebound;
 } scopeLog;
 
 /* ---------------------------------------------------------------------
@@ -76,46 +97,79 @@ public:
         this->scopeLogs.push_back(sl);
     };
     
-    // pop scopelog
+    // pop scopelog (and unbind the symbols bound in it)
     void closeScope() {
+        vector<Rebinding> &rebound = this->scopeLogs.back().rebound;
+        for (auto r = rebound.rbegin(); r != rebound.rend(); ++r) {
+            r->symbol->llvmType = r->type;
+            r->symbol->alloca = r->alloca;
+            r->symbol->depth = r->depth;
+        }
         this->scopeLogs.pop_back();
     };
 
+    // bind the symbol of a variable to its type and stack slot in the current
+    // scope, along with its name (see addVariable, changeAlloca)
+    void bind(Symbol *s, llvm::Type *type, llvm::AllocaInst *alloca) {
+        if (!s) return;
+        scopeLog &sl = this->scopeLogs.back();
+        sl.rebound.push_back(Rebinding{s, s->llvmType, s->alloca, s->depth});
+        sl.symbols[s->name] = s;
+        s->llvmType = type;
+        s->alloca = alloca;
+        s->depth = this->scopeLogs.size();
+    };
+
+    // is the symbol bound in the current scope (so that its name need not be
+    // looked up)?
+    bool bound(const Symbol *s) const {
+        return s && s->depth == this->scopeLogs.size();
+    };
+
+    // the symbol bound to a variable of the current scope, if any
+    Symbol * getCurrentScopeSymbol(Name id) {
+        auto s = this->scopeLogs.back().symbols.find(id);
+        return s == this->scopeLogs.back().symbols.end() ? nullptr : s->second;
+    };
+
     // add a variable to current scopelog
-    void addVariable(string id, llvm::Type *type, llvm::AllocaInst *alloca) {
+    void addVariable(Name id, llvm::Type *type, llvm::AllocaInst *alloca, Symbol *s = nullptr) {
         this->scopeLogs.back().variableTypes[id] = type;
         this->scopeLogs.back().variableAllocas[id] = alloca;
+        bind(s, type, alloca);
     };
 
     // change address of stack slot (used only in new)
-    void changeAlloca(string id, llvm::Type *type, llvm::AllocaInst *alloca) {
+    void changeAlloca(Name id, llvm::Type *type, llvm::AllocaInst *alloca, Symbol *s = nullptr) {
     	this->scopeLogs.back().variableAllocas[id] = alloca;
         this->scopeLogs.back().variableTypes[id] = type;
+        bind(s, type, alloca);
     };
 
     // pointer point to nullptr (dispose)
-    void disposePointer(string id) {
+    void disposePointer(Name id, Symbol *s = nullptr) {
         this->scopeLogs.back().variableAllocas[id] = nullptr;
+        if (s) bind(s, getVarType(id), nullptr);
     };
 
     // store the type of array
-    void arrayType(string id, llvm::Type *type) {
+    void arrayType(Name id, llvm::Type *type) {
     	this->scopeLogs.back().arrayTypes[id] = type;
     };
 
     // store the type of pointer
-    void pointerType(string id, llvm::Type *type){
+    void pointerType(Name id, llvm::Type *type){
     	this->scopeLogs.back().pointerTypes[id] = type;
     };
 
     // store a label with its basic block
-    void addLabel(string id, llvm::BasicBlock *body, llvm::BasicBlock *cont){
+    void addLabel(Name id, llvm::BasicBlock *body, llvm::BasicBlock *cont){
     	this->scopeLogs.back().labelsbody[id] = body;
         this->scopeLogs.back().labelscont[id] = cont;
     };
 
     // push the name of a non body function
-    void pushFunc(string func){
+    void pushFunc(Name func){
         this->scopeLogs.back().FunctionsNoBody.push(func);
     };
 
@@ -125,8 +179,8 @@ public:
     };
 
     // get the name of the last non body function
-    string getLastFunc(){
-        string ret = this->scopeLogs.back().FunctionsNoBody.top();
+    Name getLastFunc(){
+        Name ret = this->scopeLogs.back().FunctionsNoBody.top();
         return ret;
     };
 
@@ -136,22 +190,22 @@ public:
     };
 
     // add function's formals
-    void addFuncFormals(string fname, Formal_list *formals){
+    void addFuncFormals(Name fname, Formal_list *formals){
         this->scopeLogs.back().FuncsFormals[fname] = formals;
     };
 
     // add function's type
-    void addFuncType(string fname, llvm::Type *t){
+    void addFuncType(Name fname, llvm::Type *t){
         this->scopeLogs.back().FuncTypes[fname] = t;
     };
 
     // add end of func
-    void storeEndOfFunc(string fname, llvm::BasicBlock *b){
+    void storeEndOfFunc(Name fname, llvm::BasicBlock *b){
         this->scopeLogs.back().functions_ends[fname] = b;
     };
 
     // get end of func
-    llvm::BasicBlock * getEndOfFunc(string fname){
+    llvm::BasicBlock * getEndOfFunc(Name fname){
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->functions_ends.find(fname) == it->functions_ends.end()))
                 return it->functions_ends[fname];
@@ -161,7 +215,7 @@ public:
     }
 
     // get function's type
-    llvm::Type * getFuncType(string fname){
+    llvm::Type * getFuncType(Name fname){
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->FuncTypes.find(fname) == it->FuncTypes.end()))
                 return it->FuncTypes[fname];
@@ -172,7 +226,7 @@ public:
     };
 
     // get function's formals
-    Formal_list * getFuncFormals(string fname){
+    Formal_list * getFuncFormals(Name fname){
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->FuncsFormals.find(fname) == it->FuncsFormals.end()))
                 return it->FuncsFormals[fname];
@@ -184,7 +238,7 @@ public:
     };
 
     // push the name of a non body proc
-    void pushProc(string proc){
+    void pushProc(Name proc){
         this->scopeLogs.back().ProcsNoBody.push(proc);
     };
 
@@ -194,8 +248,8 @@ public:
     };
 
     // get the name of the last non body procedure
-    string getLastProc(){
-        string ret = this->scopeLogs.back().ProcsNoBody.top();
+    Name getLastProc(){
+        Name ret = this->scopeLogs.back().ProcsNoBody.top();
         return ret;
     };
 
@@ -205,12 +259,12 @@ public:
     };
 
     // add procedures formals
-    void addProcFormals(string pname, Formal_list *formals){
+    void addProcFormals(Name pname, Formal_list *formals){
         this->scopeLogs.back().ProcsFormals[pname] = formals;
     };
 
     // get procedures formals
-    Formal_list * getProcFormals(string pname){
+    Formal_list * getProcFormals(Name pname){
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->ProcsFormals.find(pname) == it->ProcsFormals.end()))
                 return it->ProcsFormals[pname];
@@ -222,16 +276,16 @@ public:
     };
 
     // store the Result of a function
-    void storeResult(string fname, llvm::Value *res){
+    void storeResult(Name fname, llvm::Value *res){
         this->scopeLogs.back().FunctionsResults[fname] = res;
     };
 
-    llvm::Value * getFuncResult(string fname){
+    llvm::Value * getFuncResult(Name fname){
         return this->scopeLogs.back().FunctionsResults[fname];
     };
 
     // lookup variable by id and return type
-    llvm::Type * getVarType(string id) {
+    llvm::Type * getVarType(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->variableTypes.find(id) == it->variableTypes.end()))
                 return it->variableTypes[id];
@@ -243,7 +297,7 @@ public:
     };
 
     // lookup array by id and return type
-    llvm::Type * getArrType(string id) {
+    llvm::Type * getArrType(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->arrayTypes.find(id) == it->arrayTypes.end()))
                 return it->arrayTypes[id];
@@ -255,7 +309,7 @@ public:
     };
 
     // lookup pointer by id and return type
-    llvm::Type * getPoinType(string id) {
+    llvm::Type * getPoinType(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->pointerTypes.find(id) == it->pointerTypes.end()))
                 return it->pointerTypes[id];
@@ -267,7 +321,7 @@ public:
     };
 
     // lookup variable by id and return address of stack slot
-    llvm::AllocaInst * getVarAlloca(string id) {
+    llvm::AllocaInst * getVarAlloca(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->variableAllocas.find(id) == it->variableAllocas.end()))
                 return it->variableAllocas[id];
@@ -279,7 +333,7 @@ public:
     };
 
     // get the block of code after a label
-    llvm::BasicBlock * getLabelBlock(string id){
+    llvm::BasicBlock * getLabelBlock(Name id){
     	for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->labelsbody.find(id) == it->labelsbody.end()))
                 return it->labelsbody[id];
@@ -291,7 +345,7 @@ public:
     };
 
     // get the block after our label's block
-    llvm::BasicBlock * getLabelCont(string id){
+    llvm::BasicBlock * getLabelCont(Name id){
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->labelscont.find(id) == it->labelscont.end()))
                 return it->labelscont[id];
@@ -303,7 +357,7 @@ public:
     };
 
     // lookup variable by id and return true if it is a pointer and false otherwise
-    bool isPointer(string id) {
+    bool isPointer(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->variableTypes.find(id) == it->variableTypes.end()))
                 return it->variableTypes[id]->isPointerTy();
@@ -316,17 +370,17 @@ public:
     };
 
     // add function to scopelog
-    void addFunctionInScope(string fname, llvm::Function *F) {
+    void addFunctionInScope(Name fname, llvm::Function *F) {
     		this->scopeLogs.back().functions[fname] = F;
     };
 
     // add proc to scopelog
-    void addProcInScope(string pname, llvm::Function *P) {
+    void addProcInScope(Name pname, llvm::Function *P) {
             this->scopeLogs.back().procedures[pname] = P;
     };
 
     // lookup function by id
-    llvm::Function * getFunctionInScope(string id) {
+    llvm::Function * getFunctionInScope(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->functions.find(id) == it->functions.end()))
                 return it->functions[id];
@@ -338,7 +392,7 @@ public:
     };
 
     // lookup procedure by id
-    llvm::Function * getProcInScope(string id) {
+    llvm::Function * getProcInScope(Name id) {
         for (auto it = this->scopeLogs.rbegin(); it != this->scopeLogs.rend(); ++it) {
             if (!(it->procedures.find(id) == it->procedures.end()))
                 return it->procedures[id];
@@ -350,14 +404,12 @@ public:
     };
 
     // getter
-    unordered_map<string, llvm::Type*> getCurrentScopeVarTypes() {
+    unordered_map<Name, llvm::Type*> getCurrentScopeVarTypes() {
         return this->scopeLogs.back().variableTypes;
     };
 
     // getter
-    unordered_map<string, llvm::AllocaInst*> getCurrentScopeVarAllocas() {
+    unordered_map<Name, llvm::AllocaInst*> getCurrentScopeVarAllocas() {
         return this->scopeLogs.back().variableAllocas;
     };
 };
-
-extern LoggedInfo loggedinfo;
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+/* ---------------------------------------------------------------------
+   -------------------------------- Names ------------------------------
+   ---------------------------------------------------------------------
+   Every identifier (and operator) spelling is interned once in a global
+   table, which keeps the only copy of its text and gives it a small,
+   stable ID: equal spellings are equal IDs. Tokens, AST nodes, the symbol
+   table and the logger pass Names around, so comparing or hashing a name
+   never touches its text. ID 0 is the empty name. Interned text is never
+   freed, c_str() and str() stay valid until the compiler exits. The
+   table is shared by the compilations of all threads.
+ ----------------------------------------------------------------------- */
+
+// Names the compiler itself refers to are interned first, in this order
+// (see builtinSpellings in name.cpp), so their IDs are constants: a Name
+// made of one of them is neither hashed nor looked up in the table.
+enum BuiltinName {
+  NAME_result = 1, NAME_main, NAME_at, NAME_dummy,
+  // the runtime library, in one run (see AST::isLibFunc)
+  NAME_writeInteger, NAME_writeBoolean, NAME_writeChar, NAME_writeReal, NAME_writeString,
+  NAME_readInteger, NAME_readBoolean, NAME_readChar, NAME_readReal, NAME_readString,
+  NAME_abs, NAME_fabs, NAME_sqrt, NAME_sin, NAME_cos, NAME_tan, NAME_arctan,
+  NAME_exp, NAME_ln, NAME_pi, NAME_trunc, NAME_round, NAME_ord, NAME_chr,
+  NAME_count
+};
+
+class Name {
+public:
+  Name() = default;  // the empty name
+  Name(const char *s);  // a null s is the empty name
+  Name(const char *s, size_t len);
+  Name(const std::string &s);
+  Name(BuiltinName b) : ID(b) {}
+
+  unsigned id() const { return ID; }
+  bool empty() const { return ID == 0; }
+  const std::string &str() const;
+  const char *c_str() const { return str().c_str(); }
+  operator const std::string &() const { return str(); }
+
+  bool operator==(Name that) const { return ID == that.ID; }
+  bool operator!=(Name that) const { return ID != that.ID; }
+  bool operator<(Name that) const { return ID < that.ID; }
+
+private:
+  friend struct NameToken;
+  unsigned ID = 0;
+};
+
+// a Name as the parser's %union holds it: a union member must be trivial,
+// which a Name is not, so this one has no value until the lexer sets it
+struct NameToken {
+  unsigned id;
+  NameToken &operator=(Name n) { id = n.ID; return *this; }
+  operator Name() const { Name n; n.ID = id; return n; }
+};
+
+inline std::ostream &operator<<(std::ostream &out, Name n) {
+  return out << n.str();
+}
+
+namespace std {
+template <> struct hash<Name> {
+  size_t operator()(Name n) const { return n.id(); }
+};
+}
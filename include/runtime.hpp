@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+/* ---------------------------------------------------------------------
+   ------------------------------ Runtime ------------------------------
+   ---------------------------------------------------------------------
+   An in-process build of the PCL runtime library (lib/lib.a), used when
+   the program is run by the JIT instead of being linked: every function
+   declared by AST::llvm_compile_and_dump has a C++ implementation here,
+   which the JIT binds to the declaration's name.
+ ----------------------------------------------------------------------- */
+
+struct RuntimeSymbol {
+  const char *name;
+  void *address;
+};
+
+extern const std::vector<RuntimeSymbol> runtimeSymbols;
@@ -26,13 +26,13 @@ public:
 		idlist = new Id_list();
 		i = "dummy4207210396";
 		idlist->append_char(i);
-		type = new Int();
+		type = Int::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 		
 		//formal_list->append(f);
 
-		st.insertProcedure("writeInteger", TYPE_proc, formal_list, false);	//maybe make a new function in st (?)
+		cx->st.insertProcedure("writeInteger", TYPE_proc, formal_list, false);	//maybe make a new function in st (?)
 
 		//proc = new Procedure("writeInteger", f, formal_list);
 
@@ -42,10 +42,10 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Bool();
+		type = Bool::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
-		st.insertProcedure("writeBoolean", TYPE_proc, formal_list, false);
+		cx->st.insertProcedure("writeBoolean", TYPE_proc, formal_list, false);
 		//proc = new Procedure("writeBoolean", f, formal_list); 
 
 		formal_list = new Formal_list();
@@ -53,10 +53,10 @@ public:
 		
 		i = "dummy4207210396";
 		idlist->append_char(i);
-		type = new Char();
+		type = Char::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
-		st.insertProcedure("writeChar", TYPE_proc, formal_list, false);
+		cx->st.insertProcedure("writeChar", TYPE_proc, formal_list, false);
 		//proc = new Procedure("writeChar", f, formal_list);
 
 		formal_list = new Formal_list();
@@ -65,12 +65,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// proc = new Procedure("writeReal", f, formal_list);
-		st.insertProcedure("writeReal", TYPE_proc, formal_list, false);
+		cx->st.insertProcedure("writeReal", TYPE_proc, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -78,26 +78,26 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Array(TYPE_char);
+		type = Array::get(TYPE_char);
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// proc = new Procedure("writeString", f, formal_list);
-		st.insertProcedure("writeString", TYPE_proc, formal_list, false);
+		cx->st.insertProcedure("writeString", TYPE_proc, formal_list, false);
 
 		//READ FUNCS
 
 		formal_list = new Formal_list();
-	    st.insertFunction("readInteger", TYPE_int, formal_list, false);
+	    cx->st.insertFunction("readInteger", TYPE_int, formal_list, false);
 
 	    formal_list = new Formal_list();
-	    st.insertFunction("readBoolean", TYPE_bool, formal_list, false);
+	    cx->st.insertFunction("readBoolean", TYPE_bool, formal_list, false);
 
 	    formal_list = new Formal_list();
-	    st.insertFunction("readChar", TYPE_char, formal_list, false);
+	    cx->st.insertFunction("readChar", TYPE_char, formal_list, false);
 
     	formal_list = new Formal_list();
-    	st.insertFunction("readReal", TYPE_real, formal_list, false);
+    	cx->st.insertFunction("readReal", TYPE_real, formal_list, false);
 
 		// func = new Function_not_from_llvm("readInteger", new Int());
 		// func = new Function_not_from_llvm("readBoolean", new Bool());
@@ -111,7 +111,7 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Int();
+		type = Int::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
@@ -121,12 +121,12 @@ public:
 		l = "dummy4207210396";
 		idlist->append_char(l);
 
-		type = new Array(TYPE_char);
+		type = Array::get(TYPE_char);
 		p = new Formal(idlist, type);
 		formal_list->append(p);
 
 		// proc = new Procedure("readString", f, formal_list);
-		st.insertProcedure("readString", TYPE_proc, formal_list, false);
+		cx->st.insertProcedure("readString", TYPE_proc, formal_list, false);
 
 		//MATH FUNCS
 
@@ -137,12 +137,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Int();
+		type = Int::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("abs", f, formal_list, new Int());
-		st.insertFunction("abs", TYPE_int, formal_list, false);
+		cx->st.insertFunction("abs", TYPE_int, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -150,12 +150,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("fabs", f, formal_list, new Real());
-		st.insertFunction("fabs", TYPE_real, formal_list, false);
+		cx->st.insertFunction("fabs", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -163,24 +163,24 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("sqrt", f, formal_list, new Real());
-		st.insertFunction("sqrt", TYPE_real, formal_list, false);
+		cx->st.insertFunction("sqrt", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
 		
 		i = "dummy4207210396";
 		idlist->append_char(i);
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("sin", f, formal_list, new Real());
-		st.insertFunction("sin", TYPE_real, formal_list, false);
+		cx->st.insertFunction("sin", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -188,12 +188,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("cos", f, formal_list, new Real());
-		st.insertFunction("cos", TYPE_real, formal_list, false);
+		cx->st.insertFunction("cos", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -201,12 +201,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("tan", f, formal_list, new Real());
-		st.insertFunction("tan", TYPE_real, formal_list, false);
+		cx->st.insertFunction("tan", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -214,12 +214,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("arctan", f, formal_list, new Real());
-		st.insertFunction("arctan", TYPE_real, formal_list, false);
+		cx->st.insertFunction("arctan", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -227,12 +227,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("exp", f, formal_list, new Real());
-		st.insertFunction("exp", TYPE_real, formal_list, false);
+		cx->st.insertFunction("exp", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -240,17 +240,17 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("ln", f, formal_list, new Real());
-		st.insertFunction("ln", TYPE_real, formal_list, false);
+		cx->st.insertFunction("ln", TYPE_real, formal_list, false);
 
 
 		// func = new Function_not_from_llvm("pi", new Real());
 		formal_list = new Formal_list();
-    	st.insertFunction("pi", TYPE_real, formal_list, false);
+    	cx->st.insertFunction("pi", TYPE_real, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -258,12 +258,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("trunc", f, formal_list, new Int());
-		st.insertFunction("trunc", TYPE_int, formal_list, false);
+		cx->st.insertFunction("trunc", TYPE_int, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -271,12 +271,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Real();
+		type = Real::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("round", f, formal_list, new Int());
-		st.insertFunction("round", TYPE_int, formal_list, false);
+		cx->st.insertFunction("round", TYPE_int, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -284,12 +284,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Char();
+		type = Char::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("ord", f, formal_list, new Int());
-		st.insertFunction("ord", TYPE_int, formal_list, false);
+		cx->st.insertFunction("ord", TYPE_int, formal_list, false);
 
 		formal_list = new Formal_list();
 		idlist = new Id_list();
@@ -297,12 +297,12 @@ public:
 		i = "dummy4207210396";
 		idlist->append_char(i);
 
-		type = new Int();
+		type = Int::get();
 		f = new Formal(idlist, type);
 		formal_list->append(f);
 
 		// func = new Function_not_from_llvm("chr", f, formal_list, new Char());
-		st.insertFunction("chr", TYPE_char, formal_list, false);
+		cx->st.insertFunction("chr", TYPE_char, formal_list, false);
 	}
 };
 
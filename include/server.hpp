@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+/* ---------------------------------------------------------------------
+   ------------------------------- Server ------------------------------
+   ---------------------------------------------------------------------
+   bin/pcl --server keeps LLVM loaded and initialized and serves compile
+   requests on a unix socket. Every request is compiled in a child forked
+   from the (untouched) server, so each compilation starts from pristine
+   globals (symbol table, logged info, module) and an "exit(1)" on a
+   semantic error only ends that request.
+
+   Request:   u32 argc, argc x (u32 length, bytes)   the command line
+              u32 length, bytes                      working directory
+              u64 length, bytes                      standard input
+   Response:  i32 exit status
+              u64 length, bytes                      standard output
+              u64 length, bytes                      standard error
+   (all integers in host byte order, the client runs on the same host)
+ ----------------------------------------------------------------------- */
+
+// $PCLC_SERVER, or server.sock in the pclc cache directory
+std::string defaultServerSocket();
+
+// serve compile requests on the given socket path (never returns normally)
+int runServer(const std::string &path);
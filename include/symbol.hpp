@@ -1,11 +1,16 @@
 #pragma once
 #include <iostream>
+#include <cstdint>
 #include <cstdlib>
 #include <vector>
+#include <deque>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include "ast.hpp"
 #include "general.hpp"
+#include "name.hpp"
+#include "diagnostics.hpp"
 
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
@@ -38,170 +43,160 @@ struct SymbolEntry {
 class Formal_list;
 class Stmt;
 
+/* ---------------------------------------------------------------------
+   -------------------------------- Scopes -----------------------------
+   ---------------------------------------------------------------------
+   Everything a scope knows about a name is kept in a single Symbol, and
+   the scope finds its symbols through one open addressing table keyed
+   by the name's ID, so that a declaration or a query is a single probe.
+   A name can have a symbol without being declared in the scope (e.g.
+   main, or a name marked new); only declared names are found by
+   lookup(). Symbols belong to the symbol table and outlive their scope:
+   the semantic analysis points the references it resolves (Id,
+   ArElement, Call, ExprCall) at them, and the code generation binds
+   their LLVM side as it compiles the declarations (see
+   LoggedInfo::bind), so that a reference compiles without looking its
+   name up again.
+   > declared:     inserted as a variable, label, procedure or function
+   > pointer:      declared as a pointer
+   > proc, func:   a procedure, a function
+   > label:        a label
+   > forward:      forward declared, and not defined yet
+   > isNew:        allocated with new
+   > formalsDone:  the formals of the procedure or function are checked
+   > arrayType:    element type of an array
+   > formals:      formals of the procedure or function
+   > hasLabelStmt,
+     labelStmt:    the statement a label marks, once it has been seen
+   > entry:        offset, type and LLVM value of the name
+   > llvmType,
+     alloca:       type and stack slot of the variable in the function
+                   being generated, while depth is the logger's depth
+   > depth:        logger scope they were bound in (0: not bound)
+   > function:     the LLVM function of a procedure or function, once it
+                   has been generated
+ ----------------------------------------------------------------------- */
+
+struct Symbol {
+  Name name = Name();
+  bool declared = false;
+  bool pointer = false;
+  bool proc = false;
+  bool func = false;
+  bool label = false;
+  bool forward = false;
+  bool isNew = false;
+  bool formalsDone = false;
+  bool hasLabelStmt = false;
+  Types arrayType = TYPE_int;
+  Formal_list *formals = nullptr;
+  Stmt *labelStmt = nullptr;
+  SymbolEntry entry;
+  llvm::Type *llvmType = nullptr;
+  llvm::AllocaInst *alloca = nullptr;
+  size_t depth = 0;
+  llvm::Function *function = nullptr;
+
+  // start over as a plain variable, keeps what does not come with a declaration
+  void declare(const SymbolEntry &e) {
+    declared = true;
+    entry = e;
+    pointer = proc = func = label = false;
+    formals = nullptr;
+  }
+};
+
 class Scope {
 public:
-  Scope() : locals(), offset(-1), size(0) {}
-  Scope(int ofs) : locals(), offset(ofs), size(0) {}
+  Scope(int ofs, std::deque<Symbol> &records)
+    : records(&records), offset(ofs), size(0), used(0), bits(4), slots(1u << bits) {}
   int getOffset() const { return offset; }
   int getSize() const { return size; }
-  SymbolEntry *lookup(std::string c) {
-    if (locals.find(c) == locals.end()) return nullptr;
-    return &(locals[c]);
+  SymbolEntry *lookup(Name c) {
+    Symbol *s = symbol(c);
+    return s ? &s->entry : nullptr;
+  }
+  // the symbol c is declared with, nullptr if it is not declared here
+  Symbol *symbol(Name c) {
+    Symbol *s = find(c);
+    return s && s->declared ? s : nullptr;
   }
-  Types lookup_type(std::string c) {
+  Types lookup_type(Name c) {
     SymbolEntry *se = lookup(c);
     return se->type;
   }
-  void insert(std::string c, Types t) {
-    if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate variable " << c << std::endl;
-      exit(1);
-    }
-    locals[c] = SymbolEntry(t, offset++);
-    ++size;
-    pointers[c] = false;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-  }
-  void insertpointer(std::string c, Types t) {
-    if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate variable " << c << std::endl;
-      exit(1);
-    }
-    locals[c] = SymbolEntry(t, offset++);
-    ++size;
-    pointers[c] = true;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-  }
-  void insert(std::string c, Types t, AllocaInst *v) {
-    if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate variable " << c << std::endl;
-      exit(1);
-    }
-    locals[c] = SymbolEntry(t, offset++, v);
-    ++size;
-    pointers[c] = false;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-  }
-  void insert(std::string c, Function *v) {
-    if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate Function " << c << std::endl;
-      exit(1);
+  void insert(Name c, Types t) {
+    if (Symbol *s = declare(c, "variable")) s->declare(SymbolEntry(t, offset++));
+  }
+  void insertpointer(Name c, Types t) {
+    if (Symbol *s = declare(c, "variable")) {
+      s->declare(SymbolEntry(t, offset++));
+      s->pointer = true;
     }
-    locals[c] = SymbolEntry(offset++, v);
-    ++size;
-    pointers[c] = false;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = true;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-  }
-  void insert(std::string c, Types t, Value* v) {
-    if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate variable " << c << std::endl;
-      exit(1);
+  }
+  void insert(Name c, Types t, AllocaInst *v) {
+    if (Symbol *s = declare(c, "variable")) s->declare(SymbolEntry(t, offset++, v));
+  }
+  void insert(Name c, Function *v) {
+    if (Symbol *s = declare(c, "Function")) {
+      s->declare(SymbolEntry(offset++, v));
+      s->func = true;
     }
-    locals[c] = SymbolEntry(t, offset++, v);
-    ++size;
-    pointers[c] = false;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-  }
-  void insertForwardDecl(std::string c, Types t){
+  }
+  void insert(Name c, Types t, Value* v) {
+    if (Symbol *s = declare(c, "variable")) s->declare(SymbolEntry(t, offset++, v));
+  }
+  void insertForwardDecl(Name c, Types t){
   	insert(c, t);
-  	Center_Forwards[c] = true;
+  	get(c).forward = true;
   }
-  void insertLabel(std::string c, Types t){
-  	if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate Label " << c << std::endl;
-      exit(1);
+  void insertLabel(Name c, Types t){
+    if (Symbol *s = declare(c, "Label")) {
+      s->declare(SymbolEntry(t, offset++));
+      s->label = true;
     }
-    locals[c] = SymbolEntry(t, offset++);
-    ++size;
-    pointers[c] = false;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = true;
-  }
-  void insertArrayType(std::string c, Types t){
-    if (locals.find(c) == locals.end()) {
-      std::cerr << "Array " << c << "could not be found in scope" << std::endl;
-      exit(1);
-    }
-    pointers[c] = false;
-    arrays[c] = t;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-  }
-  void insertProcedure(std::string c, Types t, Formal_list *f, bool forward){
-  	if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate Procedure " << c << std::endl;
-      exit(1);
+  }
+  void insertArrayType(Name c, Types t){
+    Symbol *s = find(c);
+    if (!s || !s->declared) {
+      diag().error() << "Array " << c << "could not be found in scope" << std::endl;
+      return;
     }
-    locals[c] = SymbolEntry(t, offset++);
-    ++size;
-    pointers[c] = false;
-    procs[c] = true;
-    procformals[c] = f;
-    procformalsdone[c] = false;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-    Center_Forwards[c] = forward;
+    s->pointer = s->proc = s->func = s->label = false;
+    s->formals = nullptr;
+    s->arrayType = t;
+  }
+  void insertProcedure(Name c, Types t, Formal_list *f, bool forward){
+    Symbol *s = declare(c, "Procedure");
+    if (!s) return;
+    s->declare(SymbolEntry(t, offset++));
+    s->proc = true;
+    s->formals = f;
+    s->formalsDone = false;
+    s->forward = forward;
     queue.push_back(c);
   }
-  void insertParent(std::string c){
+  void insertParent(Name c){
   	queue.push_back(c);
   }
   void insertMain(){
-    std::string c = "main";
-    procs[c] = false;
-    pointers[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = false;
-    funcformals[c] = nullptr;
-    labels[c] = false;
-    Center_Forwards[c] = false;
+    Name c(NAME_main);
+    Symbol &s = get(c);
+    s.pointer = s.proc = s.func = s.label = s.forward = false;
+    s.formals = nullptr;
     queue.push_back(c);
   }
-  void insertFunction(std::string c, Types t, Formal_list *f, bool forward){
-  	if (locals.find(c) != locals.end()) {
-      std::cerr << "Duplicate Function " << c << std::endl;
-      exit(1);
-    }
-    locals[c] = SymbolEntry(t, offset++);
-    ++size;
-    pointers[c] = false;
-    procs[c] = false;
-    procformals[c] = nullptr;
-    funcs[c] = true;
-    funcformals[c] = f;
-    funcformalsdone[c] = false;
-    labels[c] = false;
-    Center_Forwards[c] = forward;
+  void insertFunction(Name c, Types t, Formal_list *f, bool forward){
+    Symbol *s = declare(c, "Function");
+    if (!s) return;
+    s->declare(SymbolEntry(t, offset++));
+    s->func = true;
+    s->formals = f;
+    s->formalsDone = false;
+    s->forward = forward;
     queue.push_back(c);
   }
-  std::string getParentFunction(){
+  Name getParentFunction(){
     if(queue.size()>0){
       return queue.back();
     }
@@ -210,193 +205,265 @@ public:
       exit(1);
     }
   }
-  bool found(std::string c){
-    if (locals.find(c) == locals.end()) return false;
-    return true;
+  bool found(Name c){
+    Symbol *s = find(c);
+    return s && s->declared;
   }
-  bool foundForward(std::string c){
-  	if (Center_Forwards.find(c) == Center_Forwards.end()){
-  		return false;
-  	}
-  	return Center_Forwards.at(c);
+  bool foundForward(Name c){
+    Symbol *s = find(c);
+    return s && s->forward;
   }
-  bool foundProc(std::string c){
-  	return procs[c];
+  bool foundProc(Name c){
+    Symbol *s = find(c);
+    return s && s->proc;
   }
-  bool foundFunc(std::string c){
-  	return funcs[c];
+  bool foundFunc(Name c){
+    Symbol *s = find(c);
+    return s && s->func;
   }
-  void makeNew(std::string c){
-  	news[c] = true;
+  void makeNew(Name c){
+  	get(c).isNew = true;
   }
-  bool isLabel(std::string c){
-  	return labels[c];
+  bool isLabel(Name c){
+    Symbol *s = find(c);
+    return s && s->label;
   }
-  
-  bool isNew(std::string c){
-  	return news[c];
+  bool isNew(Name c){
+    Symbol *s = find(c);
+    return s && s->isNew;
   }
-  void clearForDecl(std::string c){
-  	std::map<std::string, bool>::iterator it;
-  	it = Center_Forwards.find(c);
-  	Center_Forwards.erase(it);
+  void clearForDecl(Name c){
+    if (Symbol *s = find(c)) s->forward = false;
   }
-  Formal_list *getFormalsFunc(std::string c){
-  	return funcformals[c];
+  Formal_list *getFormalsFunc(Name c){
+    Symbol *s = find(c);
+    return s && s->func ? s->formals : nullptr;
   }
-  Formal_list *getFormalsProcedure(std::string c){
-  	return procformals[c];
+  Formal_list *getFormalsProcedure(Name c){
+    Symbol *s = find(c);
+    return s && s->proc ? s->formals : nullptr;
   }
-  Types getArrayType(std::string c){
-    return arrays[c];
+  Types getArrayType(Name c){
+    Symbol *s = find(c);
+    return s ? s->arrayType : TYPE_int;
   }
-  void insertLabelStmt(std::string c, Stmt *s){
-    labelStmt[c] = s;
+  void insertLabelStmt(Name c, Stmt *st){
+    Symbol &s = get(c);
+    s.hasLabelStmt = true;
+    s.labelStmt = st;
   }
-  bool LabelHasStmt(std::string c){
-    if (labelStmt.find(c) == labelStmt.end()) return false;
-    return true;
+  bool LabelHasStmt(Name c){
+    Symbol *s = find(c);
+    return s && s->hasLabelStmt;
   }
-  bool formalsFuncDone(std::string c){
-    return funcformalsdone[c];
+  bool formalsFuncDone(Name c){
+    Symbol *s = find(c);
+    return s && s->func && s->formalsDone;
   }
-  bool formalsProcDone(std::string c){
-    return procformalsdone[c];
+  bool formalsProcDone(Name c){
+    Symbol *s = find(c);
+    return s && s->proc && s->formalsDone;
   }
-  void setformalsFuncDone(std::string c){
-    funcformalsdone[c] = true;
+  void setformalsFuncDone(Name c){
+    get(c).formalsDone = true;
   }
-  void setformalsProcDone(std::string c){
-    procformalsdone[c] = true;
+  void setformalsProcDone(Name c){
+    get(c).formalsDone = true;
   }
-  bool ispointer(std::string c){
-    return pointers[c];
+  bool ispointer(Name c){
+    Symbol *s = find(c);
+    return s && s->pointer;
   }
 private:
-  std::map<std::string, SymbolEntry> locals;
-  std::map<std::string, bool> pointers;
-  std::map<std::string, Types> arrays;
-  std::map<std::string, bool> procs;
-  std::map<std::string, Formal_list *> procformals;
-  std::map<std::string, bool> procformalsdone;
-  std::map<std::string, bool> funcs;
-  std::map<std::string, Formal_list *> funcformals;
-  std::map<std::string, bool> funcformalsdone;
-  std::map<std::string, bool> labels;
-  std::map<std::string, Stmt *> labelsStmts;
-  std::map<std::string, bool> Center_Forwards;
-  std::vector<std::string> queue;
-  std::map<std::string, bool> news;
-  std::map<std::string , Stmt *> labelStmt;
+  struct Slot {
+    Name name = Name();   // empty in a free slot
+    Symbol *symbol = nullptr;
+  };
+
+  // the symbol of c, nullptr if it has none
+  Symbol *find(Name c) {
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(c, bits);; i = (i + 1) & mask) {
+      const Slot &s = slots[i];
+      if (s.name == c) return s.symbol;
+      if (s.name.empty()) return nullptr;
+    }
+  }
+  // the symbol of c, a new one if it has none
+  Symbol &get(Name c) {
+    if (Symbol *s = find(c)) return *s;
+    if (2 * (used + 1) > slots.size()) grow();
+    size_t mask = slots.size() - 1;
+    size_t i = hash(c, bits);
+    while (!slots[i].name.empty()) i = (i + 1) & mask;
+    records->push_back(Symbol());
+    records->back().name = c;
+    slots[i].name = c;
+    slots[i].symbol = &records->back();
+    ++used;
+    return records->back();
+  }
+  // the symbol c is declared in, nullptr (reported) if it is declared already
+  Symbol *declare(Name c, const char *what) {
+    Symbol &s = get(c);
+    if (s.declared) {
+      diag().error() << "Duplicate " << what << " " << c << std::endl;
+      return nullptr;
+    }
+    ++size;
+    return &s;
+  }
+  void grow() {
+    std::vector<Slot> bigger(slots.size() * 2);
+    size_t mask = bigger.size() - 1;
+    for (const Slot &s : slots) {
+      if (s.name.empty()) continue;
+      size_t i = hash(s.name, bits + 1);
+      while (!bigger[i].name.empty()) i = (i + 1) & mask;
+      bigger[i] = s;
+    }
+    slots.swap(bigger);
+    ++bits;
+  }
+  // the slot of c in a table of 2^bits slots. IDs are handed out in
+  // sequence; the top bits of id * 2^32/phi spread them over the table
+  // (its low bits would only reorder the low bits of the ID)
+  static size_t hash(Name c, unsigned bits) { return uint32_t(c.id() * 2654435761u) >> (32 - bits); }
+
+  std::deque<Symbol> *records;  // where the symbols live (the symbol table's)
+  std::vector<Name> queue;
   int offset;
   int size;
+  size_t used;                  // slots in use
+  unsigned bits;                // log2 of slots.size()
+  std::vector<Slot> slots;      // a power of two in size, at most half full
 };
 
+/* ---------------------------------------------------------------------
+   ----------------------------- Symbol table --------------------------
+   ---------------------------------------------------------------------
+   Names are resolved without walking the scopes: every declaration
+   pushes a binding (the scope it is declared in, and the binding it
+   shadows), and visible maps every name to its innermost binding. The
+   bindings are an undo log as well, closeScope pops the bindings of the
+   scope it closes and makes the shadowed ones visible again, so finding
+   the scope a name is declared in costs the same at any nesting depth.
+   > symbols:     the symbols of every scope opened so far (they are kept
+                  for the AST, see Scope)
+   > scopes:      the open scopes, innermost last
+   > bindings:    every declaration of the open scopes, in order
+   > marks:       where the bindings of every open scope start
+   > visible:     index of the innermost binding of every declared name
+ ----------------------------------------------------------------------- */
+
 class SymbolTable {
 public:
   void openScope() {
-    // std::cout << "(OpenScope): Hey number of scopes on our programme is " << scopes.size() << "\n";
     int ofs = scopes.empty() ? 0 : scopes.back().getOffset();
-    scopes.push_back(Scope(ofs));
-    // std::cout << "(OpenScope): Hey number of scopes now on our programme is " << scopes.size() << "\n";
+    scopes.push_back(Scope(ofs, symbols));
+    marks.push_back(bindings.size());
   }
   void closeScope() {
-    // std::cout << "(CloseScope): Hey number of scopes on our programme is " << scopes.size() << "\n";
-    scopes.pop_back(); 
-    // std::cout << "(CloseScope): Hey number of scopes now on our programme is " << scopes.size() << "\n";
-  }
-  SymbolEntry *lookup(std::string c) {
-    SymbolEntry *e;
-    for (auto i = scopes.rbegin(); i != scopes.rend(); ++i) {
-      e = i->lookup(c);
-      if (e != nullptr) {return e;}
+    while (bindings.size() > marks.back()) {
+      const Binding &b = bindings.back();
+      if (b.shadowed < 0) visible.erase(b.name);
+      else visible[b.name] = b.shadowed;
+      bindings.pop_back();
     }
-    std::cerr << "Unknown variable " << c << std::endl;
-    exit(1);
-  }
-  Types lookup_type(std::string c) {
+    marks.pop_back();
+    scopes.pop_back();
+  }
+  SymbolEntry *lookup(Name c) {
+    return &lookupSymbol(c)->entry;
+  }
+  // the symbol of the declaration c resolves to, for the AST to keep
+  Symbol *lookupSymbol(Name c) {
+    if (Scope *s = resolve(c)) return s->symbol(c);
+    // declare it, so that it is reported only once
+    diag().error() << "Unknown variable " << c << std::endl;
+    insert(c, TYPE_error);
+    return scopes.back().symbol(c);
+  }
+  // the symbol c is declared with in the innermost scope, nullptr if none
+  Symbol *symbol(Name c) { return scopes.back().symbol(c); }
+  Types lookup_type(Name c) {
     SymbolEntry *se = lookup(c);
     return se->type;
   }
   int getSizeOfCurrentScope() const { return scopes.back().getSize(); }
-  void insert(std::string c, Types t) { scopes.back().insert(c, t); }
-  void insert(std::string c, Types t, AllocaInst *a) { scopes.back().insert(c, t, a); }
-  void insert(std::string c, Types t, Value *v) { scopes.back().insert(c, t, v); }
-  void insert(std::string c, Function *f) { scopes.back().insert(c, f); }
+  void insert(Name c, Types t) { bind(c); scopes.back().insert(c, t); }
+  void insert(Name c, Types t, AllocaInst *a) { bind(c); scopes.back().insert(c, t, a); }
+  void insert(Name c, Types t, Value *v) { bind(c); scopes.back().insert(c, t, v); }
+  void insert(Name c, Function *f) { bind(c); scopes.back().insert(c, f); }
   bool foundResult(){
   	SymbolEntry *e;
-  	e = scopes.back().lookup("result");
+  	e = scopes.back().lookup(NAME_result);
   	if (e != nullptr){
   		return true;
   	}
   	return false;
   }
-  Formal_list *getFormalsProcedureAll(std::string c){
-  	for (auto i = scopes.rbegin(); i != scopes.rend(); ++i){
-  		if(i->getFormalsProcedure(c)){
-  			return i->getFormalsProcedure(c);
-  		}
-  	}
-  	return nullptr;
+  Formal_list *getFormalsProcedureAll(Name c){
+    Scope *s = resolve(c);
+    return s ? s->getFormalsProcedure(c) : nullptr;
   }
-  Formal_list *getFormalsFuncAll(std::string c){
-  	for (auto i = scopes.rbegin(); i != scopes.rend(); ++i){
-  		if(i->getFormalsFunc(c)){
-  			return i->getFormalsFunc(c);
-  		}
-  	}
-  	return nullptr;
+  Formal_list *getFormalsFuncAll(Name c){
+    Scope *s = resolve(c);
+    return s ? s->getFormalsFunc(c) : nullptr;
   }
-  Types getArrayType(std::string c){
+  Types getArrayType(Name c){
     return scopes.back().getArrayType(c);
   }
-  void insertLabel(std::string c, Types t){
+  void insertLabel(Name c, Types t){
+    bind(c);
   	scopes.back().insertLabel(c,t);
   }
-  void insertPointer(std::string c, Types t){
+  void insertPointer(Name c, Types t){
+    bind(c);
     scopes.back().insertpointer(c,t);
   }
-  void insert_array_type(std::string c, Types t){
+  void insert_array_type(Name c, Types t){
     scopes.back().insertArrayType(c,t);
   }
-  void insertLabelStmt(std::string c, Stmt *s){
+  void insertLabelStmt(Name c, Stmt *s){
     scopes.back().insertLabelStmt(c, s);
   }
   void insertMain(){
     scopes.back().insertMain();
   }
-  void insertProcedure(std::string c, Types t, Formal_list *f, bool forward){
+  void insertProcedure(Name c, Types t, Formal_list *f, bool forward){
+    bind(c);
   	scopes.back().insertProcedure(c, t, f, forward);
   }
-  void insertFunction(std::string c, Types t, Formal_list *f, bool forward){
+  void insertFunction(Name c, Types t, Formal_list *f, bool forward){
     function_Types[c] = t;
+    bind(c);
   	scopes.back().insertFunction(c, t, f, forward);
   }
-  void insertForwardDecl(std::string c, Types t){
+  void insertForwardDecl(Name c, Types t){
+    bind(c);
   	scopes.back().insertForwardDecl(c, t);
   }
-  Types getFunctionType(std::string c){
+  Types getFunctionType(Name c){
     return function_Types[c];
   }
-  void makeNew(std::string c){
+  void makeNew(Name c){
   	scopes.back().makeNew(c);
   }
-  void clearForDecl(std::string c){
+  void clearForDecl(Name c){
   	scopes.back().clearForDecl(c);
   }
-  void insertParent(std::string c){
-  	for (auto i = scopes.rbegin(); i != scopes.rend(); ++i){
-  		if(i->found(c)){
-  			i->insertParent(c);
-  			return;
-  		}
-  	}
+  void insertParent(Name c){
+    if (Scope *s = resolve(c)) {
+      s->insertParent(c);
+      return;
+    }
   	std::cerr << c << " is not in a known scope!\n";
   	exit(1);
   	return;
   }
-  std::string getParent(){
-    std::string s;
+  Name getParent(){
+    Name s;
     if(scopes.size() == 1){
       s = scopes.back().getParentFunction();
       return s;
@@ -410,52 +477,67 @@ public:
       exit(1);
     }
   }
-  bool foundProc(std::string c){
-  	for (auto i = scopes.rbegin(); i != scopes.rend(); ++i){
-  		if (i->found(c)){
-  			return i->foundProc(c);
-  		}
-  	}
-  	return false;
+  bool foundProc(Name c){
+    Scope *s = resolve(c);
+    return s && s->foundProc(c);
   }
-  bool foundFunc(std::string c){
-  	for (auto i = scopes.rbegin(); i != scopes.rend(); ++i){
-  		if (i->found(c)){
-  			return i->foundFunc(c);
-  		}
-  	}
-  	return false;
+  bool foundFunc(Name c){
+    Scope *s = resolve(c);
+    return s && s->foundFunc(c);
   }
-  bool foundForward(std::string c){
+  bool foundForward(Name c){
   	return scopes.back().foundForward(c);
   }
-  bool isLabel(std::string c){
+  bool isLabel(Name c){
   	return scopes.back().isLabel(c);
   }
-  bool isNew(std::string c){
+  bool isNew(Name c){
     return scopes.back().isNew(c);
   }
-  bool LabelHasStmt(std::string s){
+  bool LabelHasStmt(Name s){
     return scopes.back().LabelHasStmt(s);
   }
-  bool formalsFuncDone(std::string c){
+  bool formalsFuncDone(Name c){
     return scopes.back().formalsFuncDone(c);
   }
-  bool formalsProcDone(std::string c){
+  bool formalsProcDone(Name c){
     return scopes.back().formalsProcDone(c);
   }
-  void setformalsFuncDone(std::string c){
+  void setformalsFuncDone(Name c){
     scopes.back().setformalsFuncDone(c);
   }
-  void setformalsProcDone(std::string c){
+  void setformalsProcDone(Name c){
     scopes.back().setformalsProcDone(c);
   }
-  bool ispointer(std::string c){
+  bool ispointer(Name c){
     return scopes.back().ispointer(c);
   }
 private:
+  struct Binding {
+    Name name;
+    unsigned scope;   // index in scopes
+    int shadowed;     // index of the binding it hides, -1 if none
+  };
+
+  // the innermost scope c is declared in, nullptr if none
+  Scope *resolve(Name c) {
+    auto v = visible.find(c);
+    return v == visible.end() ? nullptr : &scopes[bindings[v->second].scope];
+  }
+  // c is about to be declared in the innermost scope (unless it is a
+  // duplicate there, which the scope reports)
+  void bind(Name c) {
+    if (scopes.back().found(c)) return;
+    auto v = visible.find(c);
+    int shadowed = v == visible.end() ? -1 : v->second;
+    visible[c] = bindings.size();
+    bindings.push_back(Binding{c, unsigned(scopes.size() - 1), shadowed});
+  }
+
+  std::deque<Symbol> symbols;  // of every scope so far
   std::vector<Scope> scopes;
-  std::map<std::string, Types> function_Types;
+  std::vector<Binding> bindings;
+  std::vector<size_t> marks;
+  std::unordered_map<Name, int> visible;
+  std::map<Name, Types> function_Types;
 };
-
-extern SymbolTable st;
\ No newline at end of file
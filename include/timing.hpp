@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+/* ---------------------------------------------------------------------
+   ------------------------------- Timing ------------------------------
+   ---------------------------------------------------------------------
+   --time-report: wall time and peak RSS per compiler phase. A phase
+   started inside another one pauses it, so every phase is charged only
+   its own time and the phases add up to the total. With --trace every
+   phase but lex is a trace event as well. When neither is on a
+   TimePhase does nothing.
+ ----------------------------------------------------------------------- */
+
+enum Phase {
+  PHASE_lex,
+  PHASE_parse,
+  PHASE_sem,
+  PHASE_irgen,
+  PHASE_verify,
+  PHASE_opt,
+  PHASE_codegen,
+  PHASE_link,
+  PHASE_jit,
+  PHASE_count
+};
+
+class TimePhase {
+public:
+  explicit TimePhase(Phase phase);
+  ~TimePhase();
+private:
+  bool on, traced;
+  size_t event;
+};
+
+// start the clock (called once the options are known)
+void startTimeReport();
+
+// print the report to stderr, as a table or as JSON (--time-report=json)
+void printTimeReport();
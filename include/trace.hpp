@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Pass.h>
+
+#include "name.hpp"
+
+/* ---------------------------------------------------------------------
+   ------------------------------- Trace -------------------------------
+   ---------------------------------------------------------------------
+   --trace=FILE: Chrome trace events (chrome://tracing, Perfetto) for
+   the compiler phases, Body::sem and Body::compile of every routine,
+   every Local::compile, every run of an optimization pass and the
+   backend. A TraceEvent covers its own lifetime and does nothing when
+   tracing is off; events still open when the trace is written end
+   there. Events are ended by the index their begin returned rather than
+   as the innermost open one, so an end that never comes (the markers of
+   a pass run on a loop that gets deleted) can not end another event.
+ ----------------------------------------------------------------------- */
+
+bool tracing();
+
+// events that can not be tied to a scope (see TimePhase); begin returns
+// the event to end
+size_t beginTraceEvent(const char *category, const std::string &name, const std::string &unit = "");
+void endTraceEvent(size_t event);
+
+// named "what [kind] [name]", which is only put together while tracing
+class TraceEvent {
+public:
+  TraceEvent(const char *category, const char *what, Name name = Name());
+  TraceEvent(const char *category, const char *what, const std::string &kind, Name name);
+  ~TraceEvent();
+private:
+  bool on;
+  size_t event;
+};
+
+// start the clock (called once the options are known)
+void startTrace();
+
+// write the events recorded so far to the trace file
+void writeTrace();
+
+// two marker passes of P's kind, which open (first) and close (second)
+// the event of every run of P and share the event they have open; both
+// null for the passes that are not traced
+std::pair<llvm::Pass *, llvm::Pass *> createTraceMarkers(llvm::Pass *P);
+
+// a pass manager that, while tracing, brackets every pass with markers of
+// the same kind that require what it requires, so the markers do not
+// split a batch of passes that would run together without them
+template <typename PM>
+class TracingPassManager : public PM {
+public:
+  using PM::PM;
+  void add(llvm::Pass *P) override {
+    std::pair<llvm::Pass *, llvm::Pass *> markers(nullptr, nullptr);
+    if (tracing()) markers = createTraceMarkers(P);
+    if (!markers.first) return PM::add(P);
+    PM::add(markers.first);
+    PM::add(P);
+    PM::add(markers.second);
+  }
+};
@@ -0,0 +1,467 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "driver.hpp"
+#include "runtime.hpp"
+#include "server.hpp"
+#include "timing.hpp"
+#include "trace.hpp"
+
+#include <llvm/ADT/Optional.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/MCAsmBackend.h>
+#include <llvm/MC/MCAsmInfo.h>
+#include <llvm/MC/MCCodeEmitter.h>
+#include <llvm/MC/MCContext.h>
+#include <llvm/MC/MCInstrInfo.h>
+#include <llvm/MC/MCObjectFileInfo.h>
+#include <llvm/MC/MCObjectWriter.h>
+#include <llvm/MC/MCParser/MCAsmParser.h>
+#include <llvm/MC/MCParser/MCTargetAsmParser.h>
+#include <llvm/MC/MCRegisterInfo.h>
+#include <llvm/MC/MCStreamer.h>
+#include <llvm/MC/MCSubtargetInfo.h>
+#include <llvm/MC/MCTargetOptions.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Utils.h>
+
+using namespace llvm;
+
+Options options;
+
+/* ---------------------------------------------------------------------
+   --------------------------- Command line ----------------------------
+   --------------------------------------------------------------------- */
+
+static void usage(const char *prog) {
+  std::cerr << "usage: " << prog << " [-h] [--version] [-O<level>] [-x] [-i] [-f] [-c] [--emit=KIND] [--jit] [-o OUTNAME] [--runtime=LIB] [--time-report[=json]] [--trace=FILE] [--error-limit=N] [--stop-after=PHASE]\n"
+            << "       " << prog << " --server[=SOCKET]\n\n"
+            << "  infile         the PCL source code to compile (default: stdin)\n"
+            << "  -O<level>      optimization level: -O0 (default), -O1, -O2, -O3 or -Os;\n"
+            << "                 -O alone means -O3\n"
+            << "  -x, --no-dump  do not emit IR and assembly code in two seperate files\n"
+            << "  -i             print IR code to stdout, then exit\n"
+            << "  -f             print final code to stdout, then exit\n"
+            << "  -c             emit an object file instead of an executable\n"
+            << "  --emit=KIND    what to produce: exe (default), obj (same as -c) or bc (LLVM\n"
+            << "                 bitcode, written to OUTNAME or <infile>.bc)\n"
+            << "  --jit          run the program in-process instead of producing an executable\n"
+            << "  -o OUTNAME     the name of the produced file (default: a.out)\n"
+            << "  --runtime=LIB  the PCL runtime library to link against\n"
+            << "  --time-report  print the time and peak RSS of every compiler phase to stderr,\n"
+            << "                 as a table or (=json) as a single JSON line\n"
+            << "  --trace=FILE   write Chrome trace events (phases, routines, passes) to FILE\n"
+            << "  --error-limit=N\n"
+            << "                 stop after N errors (default: 20, 0 means no limit)\n"
+            << "  --stop-after=PHASE\n"
+            << "                 lex (print the number of tokens) or parse, then exit\n"
+            << "  --server       serve compile requests on SOCKET (default: $PCLC_SERVER\n"
+            << "                 or ~/.cache/pclc/server.sock), keeping LLVM loaded\n";
+}
+
+void parseOptions(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-h" or arg == "--help") {
+      usage(argv[0]);
+      exit(0);
+    }
+    else if (arg == "--version") {
+      std::cout << "pcl (LLVM " << LLVM_VERSION_STRING << ")\n";
+      exit(0);
+    }
+    else if (arg == "-O") {
+      options.optLevel = 3;
+      options.sizeLevel = 0;
+    }
+    else if (arg == "-O0" or arg == "-O1" or arg == "-O2" or arg == "-O3") {
+      options.optLevel = arg[2] - '0';
+      options.sizeLevel = 0;
+    }
+    else if (arg == "-Os") {
+      options.optLevel = 2;
+      options.sizeLevel = 1;
+    }
+    else if (arg == "-x" or arg == "--no-dump") options.dump = false;
+    else if (arg == "-i") options.dumpIR = true;
+    else if (arg == "-f") options.dumpFinal = true;
+    else if (arg == "-c") options.compileOnly = true;
+    else if (arg == "--jit") options.jit = true;
+    else if (arg == "--emit=exe") options.compileOnly = options.bitcode = false;
+    else if (arg == "--emit=obj") options.compileOnly = true;
+    else if (arg == "--emit=bc") options.bitcode = true;
+    else if (arg == "-o") {
+      if (++i == argc) {
+        std::cerr << "ERROR: -o expects an argument\n";
+        exit(1);
+      }
+      options.outname = argv[i];
+    }
+    else if (arg.compare(0, 10, "--runtime=") == 0) options.runtime = arg.substr(10);
+    else if (arg == "--time-report" or arg == "--time-report=table") options.timeReport = "table";
+    else if (arg == "--time-report=json") options.timeReport = "json";
+    else if (arg.compare(0, 8, "--trace=") == 0) options.trace = arg.substr(8);
+    else if (arg == "--stop-after=lex" or arg == "--stop-after=parse") options.stopAfter = arg.substr(13);
+    else if (arg.compare(0, 14, "--error-limit=") == 0) {
+      char *end;
+      std::string n = arg.substr(14);
+      options.errorLimit = strtoul(n.c_str(), &end, 10);
+      if (n.empty() or *end != '\0') {
+        std::cerr << "ERROR: --error-limit expects a number\n";
+        exit(1);
+      }
+    }
+    else if (arg == "--server") options.server = defaultServerSocket();
+    else if (arg.compare(0, 9, "--server=") == 0) options.server = arg.substr(9);
+    else if (arg != "-" and arg[0] == '-') {
+      std::cerr << "ERROR: unknown option " << arg << "\n";
+      usage(argv[0]);
+      exit(1);
+    }
+    else if (options.infile.empty()) options.infile = arg;
+    else {
+      std::cerr << "ERROR: only one infile can be given\n";
+      exit(1);
+    }
+  }
+
+  if (options.dumpIR and options.dumpFinal) {
+    std::cerr << "ERROR: the -i and -f flags are mutually exlusive\n";
+    exit(1);
+  }
+  if (options.jit and (options.dumpIR or options.dumpFinal or options.compileOnly or options.bitcode)) {
+    std::cerr << "ERROR: the --jit flag can not be combined with -i, -f, -c or --emit\n";
+    exit(1);
+  }
+  if (options.bitcode and (options.dumpIR or options.dumpFinal or options.compileOnly)) {
+    std::cerr << "ERROR: --emit=bc can not be combined with -i, -f or -c\n";
+    exit(1);
+  }
+
+  // define program name, the dumps are stored next to the source file
+  if (!options.infile.empty() and options.infile != "-") {
+    options.basedir = sys::path::parent_path(options.infile).str();
+    options.progname = sys::path::filename(options.infile).str();
+    if (sys::path::extension(options.progname) == ".pcl")
+      options.progname = sys::path::stem(options.progname).str();
+  }
+
+  if (options.outname.empty()) {
+    SmallString<128> name(options.basedir);
+    sys::path::append(name, options.progname + ".bc");
+    options.outname = options.bitcode ? name.str().str() : "a.out";
+  }
+
+  if (!options.timeReport.empty()) startTimeReport();
+  if (!options.trace.empty()) startTrace();
+
+  // the runtime library lives in ../lib relative to bin/pcl
+  if (options.runtime.empty()) {
+    SmallString<128> lib(sys::fs::getMainExecutable(argv[0], (void *)&parseOptions));
+    sys::path::remove_filename(lib);
+    sys::path::append(lib, "..", "lib", "lib.a");
+    options.runtime = lib.str().str();
+  }
+}
+
+/* ---------------------------------------------------------------------
+   ------------------------------ Backend ------------------------------
+   --------------------------------------------------------------------- */
+
+void initializeBackend() {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  InitializeNativeTargetAsmParser();
+}
+
+static CodeGenOpt::Level codeGenLevel() {
+  switch (options.optLevel) {
+  case 0: return CodeGenOpt::None;
+  case 1: return CodeGenOpt::Less;
+  case 2: return CodeGenOpt::Default;
+  default: return CodeGenOpt::Aggressive;
+  }
+}
+
+static TargetMachine *createTargetMachine() {
+  initializeBackend();
+
+  std::string error;
+  std::string triple = sys::getDefaultTargetTriple();
+  const Target *target = TargetRegistry::lookupTarget(triple, error);
+  if (!target) {
+    std::cerr << "ERROR: " << error << "\n";
+    exit(1);
+  }
+  return target->createTargetMachine(triple, "generic", "", TargetOptions(),
+                                     Optional<Reloc::Model>(), None, codeGenLevel());
+}
+
+// Body::compile gives every parameter and local variable its own alloca,
+// so mem2reg runs at every level (-O0 included) and code that only lives
+// in registers reaches the backend. From -O1 on, the standard pipeline of
+// the level runs on every procedure and function of the module; PCL
+// procedures are small and nested ones mostly have a single caller, so the
+// inliner is on at every level and vectorization is left to -O2 and up.
+static void optimizeModule(Module &M, TargetMachine *TM) {
+  TimePhase t(PHASE_opt);
+  TracingPassManager<legacy::FunctionPassManager> FPM(&M);
+  TracingPassManager<legacy::PassManager> MPM;
+  FPM.add(createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
+  MPM.add(createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
+  FPM.add(createPromoteMemoryToRegisterPass());
+
+  if (options.optLevel > 0) {
+    PassManagerBuilder PMB;
+    PMB.OptLevel = options.optLevel;
+    PMB.SizeLevel = options.sizeLevel;
+    PMB.Inliner = createFunctionInliningPass(PMB.OptLevel, PMB.SizeLevel, false);
+    PMB.LoopVectorize = options.optLevel >= 2 and options.sizeLevel == 0;
+    PMB.SLPVectorize = options.optLevel >= 2 and options.sizeLevel == 0;
+    TM->adjustPassManager(PMB);
+    PMB.populateFunctionPassManager(FPM);
+    PMB.populateModulePassManager(MPM);
+  }
+
+  FPM.doInitialization();
+  for (Function &F : M) FPM.run(F);
+  FPM.doFinalization();
+  MPM.run(M);
+}
+
+static void emitFile(Module &M, TargetMachine *TM, raw_pwrite_stream &out,
+                     TargetMachine::CodeGenFileType type) {
+  TimePhase t(PHASE_codegen);
+  legacy::PassManager PM;
+  if (TM->addPassesToEmitFile(PM, out, nullptr, type)) {
+    std::cerr << "ERROR: the target machine can't emit a file of this type\n";
+    exit(1);
+  }
+  PM.run(M);
+  out.flush();
+}
+
+// assemble the listing produced by the backend straight into an object file
+static void assemble(TargetMachine *TM, StringRef code, raw_pwrite_stream &out) {
+  TimePhase t(PHASE_codegen);
+  const Target &T = TM->getTarget();
+  const std::string &triple = TM->getTargetTriple().str();
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(code, "", false), SMLoc());
+
+  std::unique_ptr<MCRegisterInfo> MRI(T.createMCRegInfo(triple));
+  std::unique_ptr<MCAsmInfo> MAI(T.createMCAsmInfo(*MRI, triple));
+  std::unique_ptr<MCInstrInfo> MCII(T.createMCInstrInfo());
+  std::unique_ptr<MCSubtargetInfo> STI(
+    T.createMCSubtargetInfo(triple, TM->getTargetCPU(), TM->getTargetFeatureString()));
+  MCObjectFileInfo MOFI;
+  MCContext Ctx(MAI.get(), MRI.get(), &MOFI, &SrcMgr);
+  MOFI.InitMCObjectFileInfo(TM->getTargetTriple(), TM->isPositionIndependent(), Ctx);
+
+  MCTargetOptions MCOptions;
+  std::unique_ptr<MCAsmBackend> MAB(T.createMCAsmBackend(*STI, *MRI, MCOptions));
+  std::unique_ptr<MCObjectWriter> OW(MAB->createObjectWriter(out));
+  std::unique_ptr<MCCodeEmitter> CE(T.createMCCodeEmitter(*MCII, *MRI, Ctx));
+  std::unique_ptr<MCStreamer> Str(
+    T.createMCObjectStreamer(TM->getTargetTriple(), Ctx, std::move(MAB), std::move(OW),
+                             std::move(CE), *STI, MCOptions.MCRelaxAll,
+                             MCOptions.MCIncrementalLinkerCompatible, false));
+  std::unique_ptr<MCAsmParser> Parser(createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(T.createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+  if (!TAP) {
+    std::cerr << "ERROR: the target has no assembly parser\n";
+    exit(1);
+  }
+  Parser->setTargetParser(*TAP);
+  if (Parser->Run(false)) {
+    std::cerr << "ERROR: could not assemble the generated code\n";
+    exit(1);
+  }
+  out.flush();
+}
+
+// run the backend once: if a listing is requested, the assembly is kept
+// and assembled into the object, instead of generating code a second time
+static void emitObject(Module &M, TargetMachine *TM, raw_pwrite_stream &obj, raw_ostream *listing) {
+  if (!listing) {
+    emitFile(M, TM, obj, TargetMachine::CGFT_ObjectFile);
+    return;
+  }
+  SmallString<0> code;
+  raw_svector_ostream out(code);
+  emitFile(M, TM, out, TargetMachine::CGFT_AssemblyFile);
+  *listing << code;
+  listing->flush();
+  assemble(TM, code, obj);
+}
+
+static std::unique_ptr<raw_fd_ostream> openOutput(const std::string &name) {
+  std::error_code EC;
+  auto out = make_unique<raw_fd_ostream>(name, EC, sys::fs::F_None);
+  if (EC) {
+    std::cerr << "ERROR: could not open " << name << ": " << EC.message() << "\n";
+    exit(1);
+  }
+  return out;
+}
+
+static std::string dumpName(const char *ext) {
+  SmallString<128> name(options.basedir);
+  sys::path::append(name, options.progname + ext);
+  return name.str().str();
+}
+
+static void link(const std::string &objname) {
+  TimePhase t(PHASE_link);
+  auto linker = sys::findProgramByName("clang");
+  if (!linker) {
+    std::cerr << "ERROR: could not find clang to link the executable\n";
+    exit(1);
+  }
+  std::vector<StringRef> args = { *linker, objname, options.runtime, "-o", options.outname };
+  std::string error;
+  if (sys::ExecuteAndWait(*linker, args, None, {}, 0, 0, &error) != 0) {
+    if (!error.empty()) std::cerr << "ERROR: " << error << "\n";
+    sys::fs::remove(objname);
+    exit(1);
+  }
+}
+
+/* ---------------------------------------------------------------------
+   -------------------------------- JIT --------------------------------
+   --------------------------------------------------------------------- */
+
+static void check(Error err) {
+  if (err) {
+    std::cerr << "ERROR: " << toString(std::move(err)) << "\n";
+    exit(1);
+  }
+}
+
+// hand the module to an LLJIT instance, with the runtime library bound to
+// its in-process build, and call main
+static int runJIT(std::unique_ptr<Module> M) {
+  TimePhase t(PHASE_jit);
+  initializeBackend();
+  std::unique_ptr<TargetMachine> TM(EngineBuilder().setOptLevel(codeGenLevel()).selectTarget());
+  DataLayout DL = TM->createDataLayout();
+  M->setTargetTriple(TM->getTargetTriple().str());
+  M->setDataLayout(DL);
+
+  optimizeModule(*M, TM.get());
+
+  auto J = orc::LLJIT::Create(make_unique<orc::ExecutionSession>(), std::move(TM), DL);
+  if (!J) check(J.takeError());
+  for (const RuntimeSymbol &sym : runtimeSymbols)
+    check((*J)->defineAbsolute(sym.name, JITEvaluatedSymbol(pointerToJITTargetAddress(sym.address),
+                                                            JITSymbolFlags::Exported)));
+  check((*J)->addIRModule(std::move(M)));
+
+  auto main = (*J)->lookup("main");
+  if (!main) check(main.takeError());
+  auto *program = (int (*)())main->getAddress();
+  printTimeReport();
+  writeTrace();
+  return program();
+}
+
+/* ---------------------------------------------------------------------
+   ------------------------------- Driver ------------------------------
+   --------------------------------------------------------------------- */
+
+void runBackend(std::unique_ptr<Module> TheModule) {
+  if (options.jit) exit(runJIT(std::move(TheModule)));
+
+  // every successful compilation ends here; the time not spent in a
+  // nested phase (dumping IR, writing bitcode) is charged to codegen
+  struct ReportOnReturn {
+    ~ReportOnReturn() {
+      printTimeReport();
+      writeTrace();
+    }
+  } report;
+  TimePhase t(PHASE_codegen);
+  Module &M = *TheModule;
+  std::unique_ptr<TargetMachine> TM(createTargetMachine());
+  M.setTargetTriple(TM->getTargetTriple().str());
+  M.setDataLayout(TM->createDataLayout());
+
+  optimizeModule(M, TM.get());
+
+  // store IR in a file, -i, -f and --emit=bc included
+  if (options.dump)
+    M.print(*openOutput(dumpName(".imm")), nullptr);
+
+  // print IR or final code and exit (no executable is produced); -f
+  // stores the assembly too, generated once for both
+  if (options.dumpIR) {
+    M.print(outs(), nullptr);
+    return;
+  }
+  if (options.dumpFinal) {
+    if (!options.dump) {
+      emitFile(M, TM.get(), outs(), TargetMachine::CGFT_AssemblyFile);
+      return;
+    }
+    SmallString<0> code;
+    raw_svector_ostream out(code);
+    emitFile(M, TM.get(), out, TargetMachine::CGFT_AssemblyFile);
+    *openOutput(dumpName(".asm")) << code;
+    outs() << code;
+    return;
+  }
+
+  // no code is generated for bitcode, so there is no .asm dump
+  if (options.bitcode) {
+    WriteBitcodeToFile(M, *openOutput(options.outname));
+    return;
+  }
+
+  // store the assembly in a file, as the object is generated
+  std::unique_ptr<raw_fd_ostream> listing;
+  if (options.dump) listing = openOutput(dumpName(".asm"));
+
+  if (options.compileOnly) {
+    emitObject(M, TM.get(), *openOutput(options.outname), listing.get());
+    return;
+  }
+
+  // emit the object in a temporary file, then link it with the runtime
+  int fd;
+  SmallString<128> objname;
+  if (sys::fs::createTemporaryFile(options.progname, "o", fd, objname)) {
+    std::cerr << "ERROR: could not create a temporary object file\n";
+    exit(1);
+  }
+  {
+    raw_fd_ostream obj(fd, true);
+    emitObject(M, TM.get(), obj, listing.get());
+  }
+  link(objname.str().str());
+  sys::fs::remove(objname);
+}
@@ -102,5 +102,4 @@ char *escapeString(char *s) {
    ------- Áñ÷åßï åéóüäïõ ôïõ ìåôáãëùôôéóôÞ êáé áñéèìüò ãñáììÞò --------
    --------------------------------------------------------------------- */
 
-int linecount;
 int sem_failed = 0;
@@ -0,0 +1,130 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "name.hpp"
+
+/* ---------------------------------------------------------------------
+   ---------------------------- Intern table ---------------------------
+   ---------------------------------------------------------------------
+   > chunks:     the text of every name, indexed by ID, in chunks of
+                 ChunkSize that are never moved or freed; a chunk is
+                 published before any ID in it is handed out, so str()
+                 reads it without taking the lock
+   > count:      names interned so far (the empty name included)
+   > hashes:     the hash of every spelling, indexed by ID
+   > slots:      open addressing table of IDs (0 is a free slot, the
+                 empty name is never stored in it), a power of two in
+                 size and at most half full
+   > lock:       compilations on separate threads share the table, it
+                 guards everything but the reads of chunks
+ ----------------------------------------------------------------------- */
+
+namespace {
+
+// in the order of BuiltinName
+const char *const builtinSpellings[] = {
+  "result", "main", "@", "dummy4207210396",
+  "writeInteger", "writeBoolean", "writeChar", "writeReal", "writeString",
+  "readInteger", "readBoolean", "readChar", "readReal", "readString",
+  "abs", "fabs", "sqrt", "sin", "cos", "tan", "arctan",
+  "exp", "ln", "pi", "trunc", "round", "ord", "chr",
+};
+static_assert(sizeof(builtinSpellings) / sizeof(*builtinSpellings) == NAME_count - 1,
+              "builtinSpellings and BuiltinName disagree");
+
+struct Table {
+  static const unsigned ChunkBits = 12;
+  static const unsigned ChunkSize = 1u << ChunkBits;
+  static const unsigned MaxChunks = 1u << 14;
+
+  std::atomic<std::string *> chunks[MaxChunks] = {};
+  unsigned count = 1;
+  std::vector<size_t> hashes;
+  std::vector<unsigned> slots;
+  std::mutex lock;
+
+  Table() : hashes(1), slots(1024) {
+    chunks[0].store(new std::string[ChunkSize], std::memory_order_release);
+    for (const char *b : builtinSpellings) intern(b, strlen(b));
+  }
+
+  const std::string &spelling(unsigned id) const {
+    return chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+  }
+
+  // FNV-1a
+  static size_t hash(const char *s, size_t len) {
+    size_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; ++i) {
+      h ^= (unsigned char)s[i];
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  void grow() {
+    std::vector<unsigned> bigger(slots.size() * 2);
+    size_t mask = bigger.size() - 1;
+    for (unsigned id : slots) {
+      if (id == 0) continue;
+      size_t i = hashes[id] & mask;
+      while (bigger[i] != 0) i = (i + 1) & mask;
+      bigger[i] = id;
+    }
+    slots.swap(bigger);
+  }
+
+  unsigned intern(const char *s, size_t len) {
+    if (len == 0) return 0;
+    std::lock_guard<std::mutex> guard(lock);
+    if (2 * count >= slots.size()) grow();
+    size_t h = hash(s, len), mask = slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      unsigned id = slots[i];
+      if (id == 0) {
+        id = count;
+        if ((id >> ChunkBits) >= MaxChunks) {
+          std::cerr << "ERROR: too many names\n";
+          exit(1);
+        }
+        std::string *chunk = chunks[id >> ChunkBits].load(std::memory_order_relaxed);
+        if (!chunk) {
+          chunk = new std::string[ChunkSize];
+          chunks[id >> ChunkBits].store(chunk, std::memory_order_release);
+        }
+        chunk[id & (ChunkSize - 1)].assign(s, len);
+        ++count;
+        hashes.push_back(h);
+        slots[i] = id;
+        return id;
+      }
+      const std::string &t = spelling(id);
+      if (hashes[id] == h and t.size() == len and memcmp(t.data(), s, len) == 0)
+        return id;
+    }
+  }
+};
+
+Table &table() {
+  static Table t;
+  return t;
+}
+
+}
+
+Name::Name(const char *s) : ID(s ? table().intern(s, strlen(s)) : 0) {}
+
+Name::Name(const char *s, size_t len) : ID(table().intern(s, len)) {}
+
+Name::Name(const std::string &s) : ID(table().intern(s.data(), s.size())) {}
+
+// a Name is only ever made from an ID intern() has returned, after the
+// spelling was stored, so the read needs no lock
+const std::string &Name::str() const {
+  return table().spelling(ID);
+}
@@ -3,50 +3,37 @@
 #include "ast.hpp"
 #include "lexer.hpp"
 #include "sem_lib.hpp"
+#include "driver.hpp"
+#include "server.hpp"
 
-SymbolTable st;
-LoggedInfo loggedinfo;
-std::vector<int> rt_stack;
-
-LLVMContext AST::TheContext;
-IRBuilder<> AST::Builder(TheContext);
-std::unique_ptr<Module> AST::TheModule;
-std::unique_ptr<legacy::FunctionPassManager> AST::TheFPM;
-
-
-Function *AST::TheWriteInteger;
-Function *AST::TheWriteBoolean;
-Function *AST::TheWriteChar;
-Function *AST::TheWriteString;
-Function *AST::TheWriteReal;
-Function *AST::TheReadInteger;
-Function *AST::TheReadBoolean;
-Function *AST::TheReadChar;
-Function *AST::TheReadString;
-Function *AST::TheAbs;
-Function *AST::TheFabs;
-Function *AST::TheSqrt;
-Function *AST::TheSin;
-Function *AST::TheCos;
-Function *AST::TheTan;
-Function *AST::TheArctan;
-Function *AST::TheExp;
-Function *AST::TheLn;
-Function *AST::ThePi;
-Function *AST::TheTrunc;
-Function *AST::TheRound;
-Function *AST::TheOrd;
-Function *AST::TheChr;
-
-Type *AST::i1 = IntegerType::get(TheContext, 1);
-Type *AST::i8 = IntegerType::get(TheContext, 8);
-Type *AST::i32 = IntegerType::get(TheContext, 32);
-Type *AST::i64 = IntegerType::get(TheContext, 64);
-Type *AST::X86_FP80TyID = IntegerType::getX86_FP80Ty(TheContext);
+// the compilation running on this thread
+thread_local Compilation *cx;
 
+Diagnostics &diag() {
+	return cx->diagnostics;
+}
 
 %}
 
+%code requires {
+typedef void *yyscan_t;
+}
+
+%code {
+// every token is timed as lexing (--time-report)
+static int timedLex(YYSTYPE *lvalp, yyscan_t scanner) {
+	TimePhase t(PHASE_lex);
+	return yylex(lvalp, scanner);
+}
+#define yylex timedLex
+
+static void yyerror(yyscan_t, const char *msg) {
+	yyerror(msg);
+}
+}
+
+%define api.pure full
+%param {yyscan_t scanner}
 %define parse.error verbose
 %verbose
 %define parse.trace
@@ -141,12 +128,12 @@ Type *AST::X86_FP80TyID = IntegerType::getX86_FP80Ty(TheContext);
 	Decl_list *decl_list;
 	Type_not_from_llvm *type;
 
-	char *var;
-	char *ch;
+	NameToken var;
+	const char *ch;
 	char *str;
 	int num;
 	double real;
-	char *op;
+	Opcode op;
 }
 
 %type<body> body
@@ -170,14 +157,21 @@ Type *AST::X86_FP80TyID = IntegerType::getX86_FP80Ty(TheContext);
 
 program:
 	"program" T_id ";" body "." { 
-		st.openScope();
-		st.insertMain();
-		Library *lib = new Library();
-		lib->init();
-        //$4->printOn(std::cout);	// this was used only for debugging
-		$4->sem();
+		// a tree the parser had to repair is not worth checking
+		diag().stopIfFailed();
+		if (options.stopAfter == "parse") YYACCEPT;
+		{
+			TimePhase t(PHASE_sem);
+			cx->st.openScope();
+			cx->st.insertMain();
+			Library *lib = new Library();
+			lib->init();
+			//$4->printOn(std::cout);	// this was used only for debugging
+			$4->sem();
+		}
+		diag().stopIfFailed();
 		$4->llvm_compile_and_dump();
-		st.closeScope();
+		cx->st.closeScope();
 	}
 	;
 
@@ -197,11 +191,11 @@ local:
 	;
 
 local_label:
-	T_id id_list ";" { $$ = new Label($1, $2);}
+	id_list ";" { $$ = new Label($1);}
 	;
 
 id_list:
-	/*nothing*/ { $$ = new Id_list(); }
+	T_id { $$ = new Id_list(); $$->append_char($1); }
   	| id_list "," T_id { $1->append_char($3); $$ = $1; }
   	;
 
@@ -211,42 +205,43 @@ decl_list:
 	;
 
 decl:
-  	T_id id_list ":" type ";" { $$ = new Decl($1, $2, $4);}
+  	id_list ":" type ";" { $$ = new Decl($1, $3);}
+  	| error ";" { $$ = nullptr; }
   	;
 
 header:
-	"procedure" T_id "(" formal headerformal ")" { $$ = new Procedure($2,$4,$5); }
+	"procedure" T_id "(" headerformal ")" { $$ = new Procedure($2,$4); }
 	| "procedure" T_id "(" ")" { $$ = new Procedure($2); }
-	| "function" T_id "(" formal headerformal ")" ":" type { $$ = new Function_not_from_llvm($2, $4, $5, $8); }
+	| "function" T_id "(" headerformal ")" ":" type { $$ = new Function_not_from_llvm($2, $4, $7); }
 	| "function" T_id "(" ")" ":" type { $$ = new Function_not_from_llvm($2,$6); }
 	;
 
 headerformal:
-	/*nothing*/ { $$ = new Formal_list(); }
+	formal { $$ = new Formal_list(); $$->append($1); }
 	| headerformal ";" formal { $1->append($3); $$ = $1; }
 	;
 
 formal:
-	"var" T_id id_list ":" type { $$ = new Formal($2, $3, $5, "var"); }
-	| T_id id_list ":" type { $$ = new Formal($1,$2, $4); }
+	"var" id_list ":" type { $$ = new Formal($2, $4, "var"); }
+	| id_list ":" type { $$ = new Formal($1, $3, "ref"); }
 	;
 
 type:
-	"integer" {$$ = new Int(); }
-	| "real" { $$ = new Real(); }
-	| "boolean" { $$ = new Bool(); }
-	| "char"  { $$ = new Char(); }
-	| "array" "[" T_intconst "]" "of" type { $$ = new Array($6->get_type(), $3); }
-    | "array" "of" type { $$ = new Array($3->get_type()); }
-    | "^" type { $$ = new Pointer($2->get_type()); }
+	"integer" {$$ = Int::get(); }
+	| "real" { $$ = Real::get(); }
+	| "boolean" { $$ = Bool::get(); }
+	| "char"  { $$ = Char::get(); }
+	| "array" "[" T_intconst "]" "of" type { $$ = Array::get($6->get_type(), $3); }
+    | "array" "of" type { $$ = Array::get($3->get_type()); }
+    | "^" type { $$ = Pointer::get($2->get_type()); }
 	;
 
 block:
-	"begin" stmt blockstmt "end" {$$ = new Block($2, $3); }
+	"begin" blockstmt "end" {$$ = new Block($2); }
 	;
 
 blockstmt:
-	/*nothing*/ {$$ = new Stmtlist(); }
+	stmt {$$ = new Stmtlist(); $$->append($1); }
 	| blockstmt ";" stmt { $1->append($3); $$ = $1; }
 	;
 
@@ -263,8 +258,9 @@ stmt:
 	| "return" { $$ = new Return(); }
 	| "new" "[" expr "]" l-value { $$ = new New($3, $5); }
 	| "new" l-value { $$ = new New($2); }
-	| "dispose" "[" "]" l-value { $$ = new Dispose($2, $4); }
+	| "dispose" "[" "]" l-value { $$ = new Dispose($4, true); }
 	| "dispose" l-value { $$ = new Dispose($2); }
+	| error { $$ = nullptr; }
 	;
 
 expr:
@@ -311,23 +307,54 @@ r-value:
 	;
 
 call:
-	T_id "(" expr callexpr ")" { $$ = new Call($1, $3, $4); }
+	T_id "(" callexpr ")" { $$ = new Call($1, $3); }
 	| T_id "(" ")" { $$ = new Call($1); }
 	; 
 
 call_as_expr:
-	T_id "(" expr callexpr ")" { $$ = new ExprCall($1, $3, $4); }
+	T_id "(" callexpr ")" { $$ = new ExprCall($1, $3); }
 	| T_id "(" ")" { $$ = new ExprCall($1); }
 	;
 
 callexpr:
-	/*nothing*/ { $$ = new Exprlist(); }
+	expr { $$ = new Exprlist(); $$->append($1); }
 	| callexpr "," expr { $1->append($3); $$ = $1;}
 	;
 
 %%
 
-int main() {
-	int result = yyparse();
+int main(int argc, char **argv) {
+	parseOptions(argc, argv);
+	if (!options.server.empty()) return runServer(options.server);
+	return compileProgram(options.infile);
+}
+
+int Compilation::run(const std::string &path) {
+	Compilation *outer = cx;
+	cx = this;
+	yylex_init_extra(this, &scanner);
+	openSource(path, scanner);
+	int result = 0;
+	if (options.stopAfter == "lex") {
+		YYSTYPE value;
+		unsigned long tokens = 0;
+		while (yylex(&value, scanner) != 0) ++tokens;
+		std::cout << tokens << " tokens\n";
+	}
+	else {
+		TimePhase t(PHASE_parse);
+		result = yyparse(scanner);
+	}
+	diagnostics.stopIfFailed();
+	closeSource(scanner);
+	yylex_destroy(scanner);
+	scanner = nullptr;
+	cx = outer;
 	return result;
+}
+
+int compileProgram(const std::string &path) {
+	Compilation c;
+	c.diagnostics.limit = options.errorLimit;
+	return c.run(path);
 }
\ No newline at end of file
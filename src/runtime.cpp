@@ -0,0 +1,131 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <unistd.h>
+
+#include "runtime.hpp"
+
+// like lib.a, output goes straight to the file descriptor (no buffering)
+// and input is read a line at a time
+
+namespace runtime {
+
+void put(const char *s, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(1, s, len);
+    if (n <= 0) return;
+    s += n;
+    len -= n;
+  }
+}
+
+std::string line() {
+  std::string s;
+  char c;
+  while (read(0, &c, 1) == 1 and c != '\n') s += c;
+  return s;
+}
+
+/* ---- output ---- */
+
+void writeInteger(int64_t n) {
+  std::string s = std::to_string(n);
+  put(s.data(), s.size());
+}
+
+void writeBoolean(bool b) {
+  if (b) put("true\n", 5);
+  else put("false\n", 6);
+}
+
+void writeChar(char c) {
+  if (c) put(&c, 1);
+}
+
+void writeString(const char *s) {
+  put(s, strlen(s));
+}
+
+void writeReal(long double r) {
+  char buf[64];
+  int len = snprintf(buf, sizeof(buf), "%.5Lf", r);
+  put(buf, len);
+}
+
+/* ---- input ---- */
+
+int readInteger() {
+  return atoi(line().c_str());
+}
+
+int readBoolean() {
+  std::string s = line();
+  size_t i = s.find_first_not_of(" \t");
+  return i != std::string::npos and (s[i] | 0x20) == 't';
+}
+
+int readChar() {
+  char c;
+  do {
+    if (read(0, &c, 1) != 1) return 0;
+  } while (c == '\n');
+  return (unsigned char)c;
+}
+
+char *readString() {
+  static char buf[256];
+  std::string s = line();
+  strncpy(buf, s.c_str(), sizeof(buf) - 1);
+  return buf;
+}
+
+/* ---- arithmetic and conversions ---- */
+
+int abs(int n) { return n < 0 ? -n : n; }
+long double fabs(long double r) { return fabsl(r); }
+long double sqrt(long double r) { return sqrtl(r); }
+long double sin(long double r) { return sinl(r); }
+long double cos(long double r) { return cosl(r); }
+long double tan(long double r) { return tanl(r); }
+long double arctan(long double r) { return atanl(r); }
+long double exp(long double r) { return expl(r); }
+long double ln(long double r) { return logl(r); }
+long double pi() { return acosl(-1.0L); }
+int trunc(long double r) { return (int)truncl(r); }
+int round(long double r) { return (int)lrintl(r); }
+int ord(char c) { return (unsigned char)c; }
+char chr(int n) { return (char)n; }
+
+} // namespace runtime
+
+#define RT(name, fn) { name, reinterpret_cast<void *>(runtime::fn) }
+
+const std::vector<RuntimeSymbol> runtimeSymbols = {
+  RT("writeInteger", writeInteger),
+  RT("writeBoolean", writeBoolean),
+  RT("writeChar", writeChar),
+  RT("writeString", writeString),
+  RT("writeReal", writeReal),
+  RT("readInteger", readInteger),
+  RT("readBoolean", readBoolean),
+  RT("readChar", readChar),
+  RT("readString", readString),
+  RT("abs", abs),
+  RT("fabs", fabs),
+  RT("sqrt", sqrt),
+  RT("sin", sin),
+  RT("cos", cos),
+  RT("tan", tan),
+  RT("atan", arctan),
+  RT("exp", exp),
+  RT("ln", ln),
+  RT("pi", pi),
+  RT("trunc", trunc),
+  RT("round", round),
+  RT("ord", ord),
+  RT("chr", chr),
+};
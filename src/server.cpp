@@ -0,0 +1,186 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "driver.hpp"
+#include "server.hpp"
+
+/* ---------------------------------------------------------------------
+   ---------------------------- Socket I/O -----------------------------
+   --------------------------------------------------------------------- */
+
+static bool readAll(int fd, void *buf, size_t len) {
+  char *p = (char *)buf;
+  while (len > 0) {
+    ssize_t n = read(fd, p, len);
+    if (n < 0 and errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool writeAll(int fd, const void *buf, size_t len) {
+  const char *p = (const char *)buf;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0 and errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+template <typename Len>
+static bool readString(int fd, std::string &s) {
+  Len len;
+  if (!readAll(fd, &len, sizeof(len))) return false;
+  s.resize(len);
+  return readAll(fd, &s[0], len);
+}
+
+template <typename Len>
+static bool writeString(int fd, const std::string &s) {
+  Len len = s.size();
+  return writeAll(fd, &len, sizeof(len)) and writeAll(fd, s.data(), s.size());
+}
+
+// rewind a temporary file and return its contents
+static std::string slurp(FILE *f) {
+  std::string s;
+  char buf[1 << 16];
+  size_t n;
+  rewind(f);
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+  return s;
+}
+
+/* ---------------------------------------------------------------------
+   ------------------------------ Requests -----------------------------
+   --------------------------------------------------------------------- */
+
+// the child: redirect the standard streams and run a normal compilation
+static void compile(const std::vector<std::string> &args, const std::string &cwd,
+                    FILE *in, FILE *out, FILE *err) {
+  dup2(fileno(in), 0);
+  dup2(fileno(out), 1);
+  dup2(fileno(err), 2);
+  if (chdir(cwd.c_str()) != 0) {
+    std::cerr << "ERROR: could not change directory to " << cwd << "\n";
+    exit(1);
+  }
+
+  std::vector<char *> argv;
+  argv.push_back((char *)"pcl");
+  for (const std::string &arg : args) argv.push_back((char *)arg.c_str());
+  argv.push_back(nullptr);
+
+  options = Options();
+  parseOptions(argv.size() - 1, argv.data());
+  exit(compileProgram(options.infile));
+}
+
+static void handle(int conn) {
+  uint32_t argc;
+  std::vector<std::string> args;
+  std::string cwd, input;
+  if (!readAll(conn, &argc, sizeof(argc))) return;
+  args.resize(argc);
+  for (std::string &arg : args)
+    if (!readString<uint32_t>(conn, arg)) return;
+  if (!readString<uint32_t>(conn, cwd) or !readString<uint64_t>(conn, input)) return;
+
+  FILE *in = tmpfile(), *out = tmpfile(), *err = tmpfile();
+  if (!in or !out or !err) {
+    std::cerr << "ERROR: could not create the request's temporary files\n";
+    return;
+  }
+  fwrite(input.data(), 1, input.size(), in);
+  fflush(in);
+  rewind(in);
+
+  int32_t result;
+  pid_t pid = fork();
+  if (pid == 0) compile(args, cwd, in, out, err);
+  int status;
+  if (pid < 0 or waitpid(pid, &status, 0) < 0) {
+    fprintf(err, "ERROR: the compile server could not run the compiler\n");
+    result = 1;
+  }
+  else if (WIFEXITED(status)) result = WEXITSTATUS(status);
+  else result = 128 + WTERMSIG(status);
+
+  writeAll(conn, &result, sizeof(result)) and
+    writeString<uint64_t>(conn, slurp(out)) and
+    writeString<uint64_t>(conn, slurp(err));
+}
+
+/* ---------------------------------------------------------------------
+   ------------------------------- Server ------------------------------
+   --------------------------------------------------------------------- */
+
+std::string defaultServerSocket() {
+  if (const char *path = getenv("PCLC_SERVER")) return path;
+  std::string dir;
+  if (const char *cache = getenv("PCLC_CACHE_DIR")) dir = cache;
+  else if (const char *xdg = getenv("XDG_CACHE_HOME")) dir = std::string(xdg) + "/pclc";
+  else dir = std::string(getenv("HOME") ? getenv("HOME") : ".") + "/.cache/pclc";
+  return dir + "/server.sock";
+}
+
+int runServer(const std::string &path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "ERROR: the socket path " << path << " is too long\n";
+    exit(1);
+  }
+  strcpy(addr.sun_path, path.c_str());
+
+  // done once here, every compilation inherits an initialized backend
+  initializeBackend();
+
+  std::string dir = path.substr(0, path.rfind('/'));
+  if (dir != path and !dir.empty()) mkdir(dir.c_str(), 0700);
+  int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (sock < 0 or bind(sock, (sockaddr *)&addr, sizeof(addr)) < 0 or listen(sock, 64) < 0) {
+    std::cerr << "ERROR: could not listen on " << path << ": " << strerror(errno) << "\n";
+    exit(1);
+  }
+  std::cerr << "pcl: serving compile requests on " << path << "\n";
+
+  // request handlers are never waited for
+  signal(SIGCHLD, SIG_IGN);
+  while (true) {
+    int conn = accept(sock, nullptr, nullptr);
+    if (conn < 0) {
+      if (errno == EINTR) continue;
+      std::cerr << "ERROR: accept failed: " << strerror(errno) << "\n";
+      exit(1);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(sock);
+      signal(SIGCHLD, SIG_DFL);
+      handle(conn);
+      _exit(0);
+    }
+    close(conn);
+  }
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "driver.hpp"
+#include "timing.hpp"
+#include "trace.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+static const char *phaseNames[PHASE_count] = {
+  "lex", "parse", "sem", "irgen", "verify", "opt", "codegen", "link", "jit"
+};
+
+static bool enabled = false;
+static Clock::time_point start, last;
+static std::vector<Phase> running;
+static double seconds[PHASE_count];
+static long peakRSS[PHASE_count];  // in KB, as reported by getrusage
+static bool seen[PHASE_count];
+
+static long currentPeakRSS() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// charge the time since the last tick to the innermost running phase
+static void tick() {
+  Clock::time_point now = Clock::now();
+  if (!running.empty())
+    seconds[running.back()] += std::chrono::duration<double>(now - last).count();
+  last = now;
+}
+
+TimePhase::TimePhase(Phase phase) : on(enabled), traced(tracing() and phase != PHASE_lex), event(0) {
+  if (traced) event = beginTraceEvent("phase", phaseNames[phase]);
+  if (!on) return;
+  tick();
+  running.push_back(phase);
+  seen[phase] = true;
+}
+
+TimePhase::~TimePhase() {
+  if (traced) endTraceEvent(event);
+  if (!on) return;
+  tick();
+  // getrusage for every token would cost more than lexing it
+  if (running.back() != PHASE_lex)
+    peakRSS[running.back()] = std::max(peakRSS[running.back()], currentPeakRSS());
+  running.pop_back();
+}
+
+void startTimeReport() {
+  enabled = true;
+  start = last = Clock::now();
+}
+
+void printTimeReport() {
+  if (!enabled) return;
+  tick();
+  double total = std::chrono::duration<double>(last - start).count();
+  long peak = currentPeakRSS();
+
+  if (options.timeReport == "json") {
+    fprintf(stderr, "{\"phases\": [");
+    const char *sep = "";
+    for (int p = 0; p < PHASE_count; p++) {
+      if (!seen[p]) continue;
+      fprintf(stderr, "%s{\"name\": \"%s\", \"seconds\": %.6f, \"peak_rss_kb\": %ld}",
+              sep, phaseNames[p], seconds[p], peakRSS[p]);
+      sep = ", ";
+    }
+    fprintf(stderr, "], \"total_seconds\": %.6f, \"peak_rss_kb\": %ld}\n", total, peak);
+    return;
+  }
+
+  fprintf(stderr, "===-------------------------------------------------------------------------===\n");
+  fprintf(stderr, "                         PCL compile time report\n");
+  fprintf(stderr, "===-------------------------------------------------------------------------===\n");
+  fprintf(stderr, "  Total Execution Time: %.4f seconds, peak RSS %.1f MB\n\n", total, peak / 1024.0);
+  fprintf(stderr, "   Wall Time        Peak RSS     Phase\n");
+  for (int p = 0; p < PHASE_count; p++) {
+    if (!seen[p]) continue;
+    double percent = total > 0 ? 100 * seconds[p] / total : 0;
+    if (p == PHASE_lex)
+      fprintf(stderr, "   %.4f (%5.1f%%)       -        %s\n", seconds[p], percent, phaseNames[p]);
+    else
+      fprintf(stderr, "   %.4f (%5.1f%%)  %7.1f MB    %s\n", seconds[p], percent,
+              peakRSS[p] / 1024.0, phaseNames[p]);
+  }
+  fprintf(stderr, "   %.4f (100.0%%)  %7.1f MB    Total\n\n", total, peak / 1024.0);
+}
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "driver.hpp"
+#include "trace.hpp"
+
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/Analysis/CallGraphSCCPass.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/LoopPass.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+using namespace llvm;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Event {
+  const char *category;
+  std::string name;
+  std::string unit;  // the function (or module) a pass ran on
+  double begin, end;  // microseconds since startTrace
+};
+
+static bool enabled = false;
+static Clock::time_point start;
+static std::vector<Event> events;  // end < 0 while an event is open
+
+static double now() {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+size_t beginTraceEvent(const char *category, const std::string &name, const std::string &unit) {
+  events.push_back({ category, name, unit, now(), -1 });
+  return events.size() - 1;
+}
+
+void endTraceEvent(size_t event) {
+  if (events[event].end < 0) events[event].end = now();
+}
+
+bool tracing() { return enabled; }
+
+TraceEvent::TraceEvent(const char *category, const char *what, Name name) : on(enabled), event(0) {
+  if (!on) return;
+  std::string full = what;
+  if (!name.empty()) full += " " + name.str();
+  event = beginTraceEvent(category, full);
+}
+
+TraceEvent::TraceEvent(const char *category, const char *what, const std::string &kind, Name name)
+  : on(enabled), event(0) {
+  if (!on) return;
+  std::string full = std::string(what) + " " + kind;
+  if (!name.empty()) full += " " + name.str();
+  event = beginTraceEvent(category, full);
+}
+
+TraceEvent::~TraceEvent() {
+  if (on) endTraceEvent(event);
+}
+
+void startTrace() {
+  enabled = true;
+  start = Clock::now();
+}
+
+static std::string quote(const std::string &s) {
+  std::string q = "\"";
+  for (char c : s) {
+    if (c == '"' or c == '\\') q += '\\';
+    if ((unsigned char)c >= 0x20) q += c;
+  }
+  return q + "\"";
+}
+
+void writeTrace() {
+  if (!enabled) return;
+  FILE *out = fopen(options.trace.c_str(), "w");
+  if (!out) {
+    std::cerr << "ERROR: could not open " << options.trace << "\n";
+    exit(1);
+  }
+  double end = now();
+  fprintf(out, "{\"traceEvents\": [\n");
+  for (size_t i = 0; i < events.size(); i++) {
+    const Event &e = events[i];
+    fprintf(out, "  {\"name\": %s, \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                 "\"pid\": 1, \"tid\": 1",
+            quote(e.name).c_str(), e.category, e.begin, (e.end < 0 ? end : e.end) - e.begin);
+    if (!e.unit.empty()) fprintf(out, ", \"args\": {\"unit\": %s}", quote(e.unit).c_str());
+    fprintf(out, "}%s\n", i + 1 < events.size() ? "," : "");
+  }
+  fprintf(out, "], \"displayTimeUnit\": \"ms\"}\n");
+  fclose(out);
+}
+
+/* ---------------------------------------------------------------------
+   ---------------------------- Pass markers ---------------------------
+   --------------------------------------------------------------------- */
+
+namespace {
+
+// the event the begin marker of a pass has open, shared with the end marker
+struct Slot {
+  size_t event = 0;
+  bool open = false;
+};
+
+// what a marker does on every run. Markers preserve everything, so they
+// never cause an analysis to be recomputed, and require what the pass
+// they bracket requires, so the analyses it needs are scheduled before
+// the begin marker instead of splitting the markers and the pass into
+// separate pass managers. The end marker requires only what the pass
+// preserves, so nothing is scheduled between the pass and it.
+struct Marker {
+  std::string pass;
+  bool begin;
+  Pass *wrapped;
+  std::shared_ptr<Slot> slot;
+
+  void mark(const std::string &unit) {
+    // still open on a begin: the end of the last run never came
+    if (slot->open) endTraceEvent(slot->event);
+    slot->open = begin;
+    if (begin) slot->event = beginTraceEvent("pass", pass, unit);
+  }
+  // for a loop that gets deleted, the loop pass manager skips the rest of
+  // its passes, end markers included, and releases them instead
+  void release() {
+    if (begin or !slot->open) return;
+    endTraceEvent(slot->event);
+    slot->open = false;
+  }
+  void requirements(AnalysisUsage &AU) const {
+    AnalysisUsage usage;
+    wrapped->getAnalysisUsage(usage);
+    const AnalysisUsage::VectorType &preserved = usage.getPreservedSet();
+    for (AnalysisID id : usage.getRequiredSet())
+      if (begin or usage.getPreservesAll() or
+          std::find(preserved.begin(), preserved.end(), id) != preserved.end())
+        AU.addRequiredID(id);
+    AU.setPreservesAll();
+  }
+};
+
+struct FunctionMarker : public FunctionPass, Marker {
+  static char ID;
+  FunctionMarker(const Marker &m) : FunctionPass(ID), Marker(m) {}
+  StringRef getPassName() const override { return "Trace marker"; }
+  void getAnalysisUsage(AnalysisUsage &AU) const override { requirements(AU); }
+  bool runOnFunction(Function &F) override {
+    mark(F.getName().str());
+    return false;
+  }
+};
+
+struct ModuleMarker : public ModulePass, Marker {
+  static char ID;
+  ModuleMarker(const Marker &m) : ModulePass(ID), Marker(m) {}
+  StringRef getPassName() const override { return "Trace marker"; }
+  void getAnalysisUsage(AnalysisUsage &AU) const override { requirements(AU); }
+  bool runOnModule(Module &M) override {
+    mark("module");
+    return false;
+  }
+};
+
+struct SCCMarker : public CallGraphSCCPass, Marker {
+  static char ID;
+  SCCMarker(const Marker &m) : CallGraphSCCPass(ID), Marker(m) {}
+  StringRef getPassName() const override { return "Trace marker"; }
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    CallGraphSCCPass::getAnalysisUsage(AU);
+    requirements(AU);
+  }
+  bool runOnSCC(CallGraphSCC &SCC) override {
+    Function *F = (*SCC.begin())->getFunction();
+    mark(F ? F->getName().str() : "external");
+    return false;
+  }
+};
+
+struct LoopMarker : public LoopPass, Marker {
+  static char ID;
+  LoopMarker(const Marker &m) : LoopPass(ID), Marker(m) {}
+  StringRef getPassName() const override { return "Trace marker"; }
+  void getAnalysisUsage(AnalysisUsage &AU) const override { requirements(AU); }
+  bool runOnLoop(Loop *L, LPPassManager &) override {
+    mark(L->getHeader()->getParent()->getName().str());
+    return false;
+  }
+  void releaseMemory() override { release(); }
+};
+
+char FunctionMarker::ID = 0;
+char ModuleMarker::ID = 0;
+char SCCMarker::ID = 0;
+char LoopMarker::ID = 0;
+
+template <typename M>
+std::pair<Pass *, Pass *> markerPair(const Marker &begin, const Marker &end) {
+  return std::make_pair(new M(begin), new M(end));
+}
+
+} // namespace
+
+std::pair<Pass *, Pass *> createTraceMarkers(Pass *P) {
+  std::pair<Pass *, Pass *> none(nullptr, nullptr);
+  if (P->getAsImmutablePass()) return none;
+  std::shared_ptr<Slot> slot = std::make_shared<Slot>();
+  Marker begin = { P->getPassName().str(), true, P, slot };
+  Marker end = { P->getPassName().str(), false, P, slot };
+  switch (P->getPassKind()) {
+  case PT_Function: return markerPair<FunctionMarker>(begin, end);
+  case PT_Module: return markerPair<ModuleMarker>(begin, end);
+  case PT_CallGraphSCC: return markerPair<SCCMarker>(begin, end);
+  case PT_Loop: return markerPair<LoopMarker>(begin, end);
+  default: return none;
+  }
+}